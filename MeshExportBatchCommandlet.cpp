@@ -0,0 +1,274 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MeshExportBatchCommandlet.h"
+#include "MeshMergerExporter.h"
+#include "MeshExportCommandletUtils.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/OutputDeviceFile.h"
+#include "Misc/PackageName.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+// Outcome of one map, as stored in the summary
+struct FMeshExportBatchResult
+{
+    FString Map;
+    FString FilePath;
+    FString LogPath;
+    double Seconds = 0.0;
+    bool bSuccess = false;
+};
+
+UMeshExportBatchCommandlet::UMeshExportBatchCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+#if WITH_EDITOR
+static bool ExportMap(const FString& Map, const FString& OutputRoot, bool bGLTF, const FString& MergeOverride, FMeshExportBatchResult& OutResult)
+{
+    const FString MapName = FPackageName::GetShortName(Map);
+    const FString Directory = OutputRoot / MapName;
+    FPlatformFileManager::Get().GetPlatformFile().CreateDirectoryTree(*Directory);
+
+    OutResult.Map = Map;
+    OutResult.FilePath = Directory / (MapName + (bGLTF ? TEXT(".glb") : TEXT(".obj")));
+    OutResult.LogPath = Directory / (MapName + TEXT(".log"));
+
+    // Everything logged while this map is exported also goes to its own file
+    FOutputDeviceFile MapLog(*OutResult.LogPath, true);
+    GLog->AddOutputDevice(&MapLog);
+
+    const double StartTime = FPlatformTime::Seconds();
+    UE_LOG(LogTemp, Display, TEXT("Exporting map %s to %s"), *Map, *OutResult.FilePath);
+
+    if (UWorld* World = MeshExportCommandlet::LoadWorld(Map))
+    {
+        // An exporter placed in the map carries the settings chosen for it
+        TActorIterator<AMeshMergerExporter> PlacedExporter(World);
+        AMeshMergerExporter* Exporter = PlacedExporter ? *PlacedExporter : World->SpawnActor<AMeshMergerExporter>();
+        if (MergeOverride == TEXT("Merge") || MergeOverride == TEXT("NoMerge"))
+        {
+            Exporter->ExportSettings.bMergeMeshes = MergeOverride == TEXT("Merge");
+        }
+        Exporter->ExportSettings.bWriteExportReport = true;
+
+        Exporter->MergeAndExportMeshes(OutResult.FilePath, bGLTF);
+        OutResult.bSuccess = Exporter->LastExportReport.bSuccess;
+
+        MeshExportCommandlet::DestroyWorld(World);
+    }
+
+    OutResult.Seconds = FPlatformTime::Seconds() - StartTime;
+    UE_LOG(LogTemp, Display, TEXT("Map %s %s after %.1f s"), *Map, OutResult.bSuccess ? TEXT("exported") : TEXT("failed"), OutResult.Seconds);
+
+    GLog->Flush();
+    GLog->RemoveOutputDevice(&MapLog);
+    MapLog.TearDown();
+    return OutResult.bSuccess;
+}
+
+static bool SaveSummary(const TArray<FMeshExportBatchResult>& Results, const FString& SummaryPath)
+{
+    FString Text;
+    TSharedRef<TJsonWriter<>> Json = TJsonWriterFactory<>::Create(&Text);
+    Json->WriteObjectStart();
+    Json->WriteArrayStart(TEXT("maps"));
+    for (const FMeshExportBatchResult& Result : Results)
+    {
+        Json->WriteObjectStart();
+        Json->WriteValue(TEXT("map"), Result.Map);
+        Json->WriteValue(TEXT("success"), Result.bSuccess);
+        Json->WriteValue(TEXT("seconds"), Result.Seconds);
+        Json->WriteValue(TEXT("file"), Result.FilePath);
+        Json->WriteValue(TEXT("log"), Result.LogPath);
+        Json->WriteObjectEnd();
+    }
+    Json->WriteArrayEnd();
+    Json->WriteObjectEnd();
+    Json->Close();
+
+    if (!FFileHelper::SaveStringToFile(Text, *SummaryPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to save batch summary: %s"), *SummaryPath);
+        return false;
+    }
+    return true;
+}
+
+// Adds the maps of a summary written by SaveSummary to OutResults
+static bool LoadSummary(const FString& SummaryPath, TArray<FMeshExportBatchResult>& OutResults)
+{
+    FString Text;
+    TSharedPtr<FJsonObject> Root;
+    const TArray<TSharedPtr<FJsonValue>>* Maps = nullptr;
+    if (!FFileHelper::LoadFileToString(Text, *SummaryPath)
+        || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Text), Root)
+        || !Root.IsValid() || !Root->TryGetArrayField(TEXT("maps"), Maps))
+    {
+        return false;
+    }
+
+    for (const TSharedPtr<FJsonValue>& Value : *Maps)
+    {
+        const TSharedPtr<FJsonObject>* Map = nullptr;
+        if (Value->TryGetObject(Map))
+        {
+            FMeshExportBatchResult& Result = OutResults.AddDefaulted_GetRef();
+            Result.Map = (*Map)->GetStringField(TEXT("map"));
+            Result.bSuccess = (*Map)->GetBoolField(TEXT("success"));
+            Result.Seconds = (*Map)->GetNumberField(TEXT("seconds"));
+            Result.FilePath = (*Map)->GetStringField(TEXT("file"));
+            Result.LogPath = (*Map)->GetStringField(TEXT("log"));
+        }
+    }
+    return true;
+}
+
+// Splits Maps round-robin over NumProcesses child editors running this commandlet and gathers their summaries
+static TArray<FMeshExportBatchResult> RunShards(const TArray<FString>& Maps, int32 NumProcesses, const FString& OutputRoot, const FString& Format, const FString& MergeOverride)
+{
+    const FString ShardDirectory = OutputRoot / TEXT("Shards");
+    FPlatformFileManager::Get().GetPlatformFile().CreateDirectoryTree(*ShardDirectory);
+
+    const FString ProjectFile = FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath());
+    TArray<FProcHandle> Processes;
+    TArray<FString> SummaryPaths;
+    for (int32 Shard = 0; Shard < NumProcesses; Shard++)
+    {
+        TArray<FString> ShardMaps;
+        for (int32 MapIndex = Shard; MapIndex < Maps.Num(); MapIndex += NumProcesses)
+        {
+            ShardMaps.Add(Maps[MapIndex]);
+        }
+
+        const FString ShardName = FString::Printf(TEXT("Shard%d"), Shard);
+        const FString MapListPath = ShardDirectory / (ShardName + TEXT(".txt"));
+        const FString SummaryPath = ShardDirectory / (ShardName + TEXT(".json"));
+        const FString LogPath = ShardDirectory / (ShardName + TEXT(".log"));
+        FFileHelper::SaveStringArrayToFile(ShardMaps, *MapListPath);
+        IFileManager::Get().Delete(*SummaryPath);
+
+        const FString Args = FString::Printf(TEXT("\"%s\" -run=MeshExportBatch -MapList=\"%s\" -Output=\"%s\" -Format=%s -Summary=\"%s\" -abslog=\"%s\" %s -unattended -nopause -nosplash"),
+            *ProjectFile, *MapListPath, *OutputRoot, *Format, *SummaryPath, *LogPath, MergeOverride.IsEmpty() ? TEXT("") : *(TEXT("-") + MergeOverride));
+
+        FProcHandle Process = FPlatformProcess::CreateProc(FPlatformProcess::ExecutablePath(), *Args, false, true, true, nullptr, 0, nullptr, nullptr);
+        if (!Process.IsValid())
+        {
+            UE_LOG(LogTemp, Error, TEXT("Failed to start the process for %s"), *ShardName);
+            continue;
+        }
+
+        UE_LOG(LogTemp, Display, TEXT("Started %s with %d maps, log: %s"), *ShardName, ShardMaps.Num(), *LogPath);
+        Processes.Add(Process);
+        SummaryPaths.Add(SummaryPath);
+    }
+
+    TArray<FMeshExportBatchResult> Results;
+    for (int32 Index = 0; Index < Processes.Num(); Index++)
+    {
+        FPlatformProcess::WaitForProc(Processes[Index]);
+        int32 ReturnCode = 0;
+        FPlatformProcess::GetProcReturnCode(Processes[Index], &ReturnCode);
+        FPlatformProcess::CloseProc(Processes[Index]);
+
+        if (!LoadSummary(SummaryPaths[Index], Results))
+        {
+            UE_LOG(LogTemp, Error, TEXT("Shard exited with code %d without a summary: %s"), ReturnCode, *SummaryPaths[Index]);
+        }
+    }
+
+    // Maps of a shard that crashed part way have no result; they are reported as failed
+    for (const FString& Map : Maps)
+    {
+        if (!Results.ContainsByPredicate([&Map](const FMeshExportBatchResult& Result) { return Result.Map == Map; }))
+        {
+            Results.AddDefaulted_GetRef().Map = Map;
+        }
+    }
+    return Results;
+}
+#endif
+
+int32 UMeshExportBatchCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+    TArray<FString> Maps = MeshExportCommandlet::ParseList(Params, TEXT("Maps="), TEXT(""));
+    FString MapListPath;
+    if (FParse::Value(*Params, TEXT("MapList="), MapListPath) && !MeshExportCommandlet::LoadMapList(MapListPath, Maps))
+    {
+        return 1;
+    }
+
+    if (Maps.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("No maps to export, pass -Maps= or -MapList="));
+        return 1;
+    }
+
+    FString OutputRoot = FPaths::ProjectSavedDir() / TEXT("MeshExportBatch");
+    FParse::Value(*Params, TEXT("Output="), OutputRoot);
+    OutputRoot = FPaths::ConvertRelativePathToFull(OutputRoot);
+
+    FString Format = TEXT("glb");
+    FParse::Value(*Params, TEXT("Format="), Format);
+    const bool bGLTF = Format != TEXT("obj");
+
+    const FString MergeOverride = FParse::Param(*Params, TEXT("NoMerge")) ? TEXT("NoMerge") : FParse::Param(*Params, TEXT("Merge")) ? TEXT("Merge") : TEXT("");
+
+    FString SummaryPath = OutputRoot / TEXT("summary.json");
+    FParse::Value(*Params, TEXT("Summary="), SummaryPath);
+
+    int32 NumProcesses = 1;
+    FParse::Value(*Params, TEXT("Processes="), NumProcesses);
+    NumProcesses = FMath::Clamp(NumProcesses, 1, Maps.Num());
+
+    const double StartTime = FPlatformTime::Seconds();
+    TArray<FMeshExportBatchResult> Results;
+    if (NumProcesses > 1)
+    {
+        Results = RunShards(Maps, NumProcesses, OutputRoot, Format, MergeOverride);
+    }
+    else
+    {
+        for (const FString& Map : Maps)
+        {
+            ExportMap(Map, OutputRoot, bGLTF, MergeOverride, Results.AddDefaulted_GetRef());
+
+            // Written after every map, so a crash still leaves the results of the maps before it
+            SaveSummary(Results, SummaryPath);
+        }
+    }
+    SaveSummary(Results, SummaryPath);
+
+    int32 NumFailed = 0;
+    for (const FMeshExportBatchResult& Result : Results)
+    {
+        if (!Result.bSuccess)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Failed: %s%s"), *Result.Map, Result.LogPath.IsEmpty() ? TEXT("") : *(TEXT(", see ") + Result.LogPath));
+            NumFailed++;
+        }
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("Exported %d of %d maps in %.1f s on %d processes, summary: %s"),
+        Results.Num() - NumFailed, Results.Num(), FPlatformTime::Seconds() - StartTime, NumProcesses, *SummaryPath);
+    return NumFailed == 0 ? 0 : 1;
+#else
+    UE_LOG(LogTemp, Error, TEXT("Batch mesh export needs an editor build"));
+    return 1;
+#endif
+}
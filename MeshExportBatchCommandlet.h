@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MeshExportBatchCommandlet.generated.h"
+
+/**
+ * Exports many maps without an interactive editor: each map is loaded, collected, merged and exported like
+ * AMeshMergerExporter::MergeAndExportMeshes would, then unloaded again.
+ *
+ *   -run=MeshExportBatch (-Maps=/Game/A,/Game/B | -MapList=Maps.txt) [-Output=Dir] [-Format=glb|obj] [-Merge | -NoMerge]
+ *       [-Processes=4] [-Summary=File.json]
+ *
+ * Maps are written to Output/<Map>/<Map>.<Format> with a <Map>.log of everything logged while exporting them and the
+ * export report next to them. The settings of an exporter actor placed in the map are used when there is one.
+ * With -Processes above 1 the map list is split over that many child editor processes, each with its own log, and
+ * their results are gathered into one summary. Returns 1 if any map failed.
+ */
+UCLASS()
+class SAFRAN_APP_API UMeshExportBatchCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UMeshExportBatchCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,422 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MeshExportBenchmarkCommandlet.h"
+#include "MeshMergerExporter.h"
+#include "MeshExportReport.h"
+#include "MeshExportCommandletUtils.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/Texture2D.h"
+#include "Components/StaticMeshComponent.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialInstanceConstant.h"
+#include "Materials/MaterialExpressionTextureSampleParameter2D.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/PackageName.h"
+#include "Misc/Parse.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+// Best run of one scene, mode and format
+struct FMeshExportBenchmarkResult
+{
+    FString Name;
+    double Seconds = 0.0;
+    int64 VerticesWritten = 0;
+    int64 BytesWritten = 0;
+    /** How far used physical memory rose above what the process used before the run started. */
+    int64 PeakMemoryRise = 0;
+    TArray<FMeshExportStageReport> Stages;
+
+    double GetVerticesPerSecond() const { return Seconds > 0.0 ? VerticesWritten / Seconds : 0.0; }
+    double GetMegabytesPerSecond() const { return Seconds > 0.0 ? BytesWritten / (1024.0 * 1024.0) / Seconds : 0.0; }
+};
+
+UMeshExportBenchmarkCommandlet::UMeshExportBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+#if WITH_EDITOR
+// Texture parameter named ParameterName, sampling DefaultTexture unless an instance overrides it, feeding Input
+static void AddTextureParameter(UMaterial* Material, FName ParameterName, UTexture2D* DefaultTexture, EMaterialSamplerType SamplerType, FExpressionInput& Input)
+{
+    UMaterialExpressionTextureSampleParameter2D* Expression = NewObject<UMaterialExpressionTextureSampleParameter2D>(Material);
+    Expression->ParameterName = ParameterName;
+    Expression->Texture = DefaultTexture;
+    Expression->SamplerType = SamplerType;
+    Material->GetExpressionCollection().AddExpression(Expression);
+    Input.Connect(0, Expression);
+}
+
+// Parent of the benchmark materials, with BaseColor and Normal texture parameters like a typical surface material
+static UMaterial* CreateBenchmarkParentMaterial(UWorld* World, UTexture2D* BaseColor, UTexture2D* Normal)
+{
+    UMaterial* Material = NewObject<UMaterial>(World, TEXT("BenchmarkParentMaterial"), RF_Transient);
+    AddTextureParameter(Material, FName("BaseColor"), BaseColor, SAMPLERTYPE_Color, Material->GetEditorOnlyData()->BaseColor);
+    AddTextureParameter(Material, FName("Normal"), Normal, SAMPLERTYPE_Normal, Material->GetEditorOnlyData()->Normal);
+    Material->PostEditChange();
+    return Material;
+}
+
+// Grid of basic shapes cycling through NumMaterials material instances, which cycle through NumTextures textures
+static UWorld* CreateSyntheticWorld(int32 NumActors, int32 NumMaterials, int32 NumTextures, int32 TextureSize)
+{
+    UWorld* World = UWorld::CreateWorld(EWorldType::Editor, false, *FString::Printf(TEXT("MeshExportBenchmark_%d"), NumActors));
+    MeshExportCommandlet::AddWorldContext(World);
+
+    // A pattern rather than noise, so the encoders see something closer to real texture content
+    TArray<UTexture2D*> Textures;
+    TArray<uint8> Pixels;
+    Pixels.SetNumUninitialized(static_cast<int64>(TextureSize) * TextureSize * 4);
+    for (int32 TextureIndex = 0; TextureIndex < NumTextures; TextureIndex++)
+    {
+        for (int32 Y = 0; Y < TextureSize; Y++)
+        {
+            for (int32 X = 0; X < TextureSize; X++)
+            {
+                uint8* Pixel = &Pixels[(static_cast<int64>(Y) * TextureSize + X) * 4];
+                Pixel[0] = static_cast<uint8>((X ^ Y) + TextureIndex * 37);
+                Pixel[1] = static_cast<uint8>(X + TextureIndex * 59);
+                Pixel[2] = static_cast<uint8>(Y + TextureIndex * 83);
+                Pixel[3] = 255;
+            }
+        }
+
+        UTexture2D* Texture = NewObject<UTexture2D>(World, *FString::Printf(TEXT("BenchmarkTexture_%d"), TextureIndex), RF_Transient);
+        Texture->Source.Init(TextureSize, TextureSize, 1, 1, TSF_BGRA8, Pixels.GetData());
+
+        // The exporter shares jobs between textures with the same source id
+        Texture->Source.SetId(FGuid::NewGuid(), false);
+        Textures.Add(Texture);
+    }
+
+    // One flat normal map shared by every material, so the normal channel is exported at the same size as base color
+    UMaterialInterface* Parent = UMaterial::GetDefaultMaterial(MD_Surface);
+    if (Textures.Num() > 0)
+    {
+        for (int64 PixelIndex = 0; PixelIndex < static_cast<int64>(TextureSize) * TextureSize; PixelIndex++)
+        {
+            uint8* Pixel = &Pixels[PixelIndex * 4];
+            Pixel[0] = 255;
+            Pixel[1] = 128;
+            Pixel[2] = 128;
+            Pixel[3] = 255;
+        }
+
+        UTexture2D* Normal = NewObject<UTexture2D>(World, TEXT("BenchmarkTexture_N"), RF_Transient);
+        Normal->Source.Init(TextureSize, TextureSize, 1, 1, TSF_BGRA8, Pixels.GetData());
+        Normal->Source.SetId(FGuid::NewGuid(), false);
+        Normal->CompressionSettings = TC_Normalmap;
+        Normal->SRGB = false;
+        Normal->PostEditChange();
+
+        Parent = CreateBenchmarkParentMaterial(World, Textures[0], Normal);
+    }
+
+    TArray<UMaterialInterface*> Materials;
+    for (int32 MaterialIndex = 0; MaterialIndex < NumMaterials; MaterialIndex++)
+    {
+        UMaterialInstanceConstant* Material = NewObject<UMaterialInstanceConstant>(World, *FString::Printf(TEXT("BenchmarkMaterial_%d"), MaterialIndex), RF_Transient);
+        Material->SetParentEditorOnly(Parent);
+        if (Textures.Num() > 0)
+        {
+            Material->SetTextureParameterValueEditorOnly(FName("BaseColor"), Textures[MaterialIndex % Textures.Num()]);
+        }
+        Materials.Add(Material);
+    }
+
+    const TCHAR* MeshPaths[] = {
+        TEXT("/Engine/BasicShapes/Cube.Cube"),
+        TEXT("/Engine/BasicShapes/Sphere.Sphere"),
+        TEXT("/Engine/BasicShapes/Cylinder.Cylinder"),
+    };
+    TArray<UStaticMesh*> Meshes;
+    for (const TCHAR* MeshPath : MeshPaths)
+    {
+        if (UStaticMesh* Mesh = LoadObject<UStaticMesh>(nullptr, MeshPath))
+        {
+            Meshes.Add(Mesh);
+        }
+    }
+
+    if (Meshes.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Engine basic shapes are missing, cannot build a synthetic scene"));
+        return World;
+    }
+
+    const int32 GridSize = FMath::Max(FMath::CeilToInt32(FMath::Sqrt(static_cast<float>(NumActors))), 1);
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    for (int32 ActorIndex = 0; ActorIndex < NumActors; ActorIndex++)
+    {
+        const FVector Location((ActorIndex % GridSize) * 200.0, (ActorIndex / GridSize) * 200.0, 0.0);
+        AStaticMeshActor* Actor = World->SpawnActor<AStaticMeshActor>(Location, FRotator::ZeroRotator, SpawnParams);
+        UStaticMeshComponent* Component = Actor->GetStaticMeshComponent();
+        Component->SetStaticMesh(Meshes[ActorIndex % Meshes.Num()]);
+        if (Materials.Num() > 0)
+        {
+            Component->SetMaterial(0, Materials[ActorIndex % Materials.Num()]);
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Created synthetic scene: %d actors, %d materials, %d textures of %d pixels"),
+        NumActors, Materials.Num(), Textures.Num(), TextureSize);
+    return World;
+}
+
+static int64 GetDirectorySize(const FString& Directory)
+{
+    TArray<FString> Files;
+    IFileManager::Get().FindFilesRecursive(Files, *Directory, TEXT("*"), true, false);
+
+    int64 Size = 0;
+    for (const FString& File : Files)
+    {
+        Size += FMath::Max<int64>(IFileManager::Get().FileSize(*File), 0);
+    }
+    return Size;
+}
+
+// Exports World Iterations times into a fresh folder each time and keeps the fastest run
+static bool RunCase(UWorld* World, const FString& CaseName, bool bMergeMeshes, bool bGLTF, int32 Iterations, const FString& OutputRoot, FMeshExportBenchmarkResult& OutResult)
+{
+    AMeshMergerExporter* Exporter = World->SpawnActor<AMeshMergerExporter>();
+    Exporter->ExportSettings.bMergeMeshes = bMergeMeshes;
+
+    const FString Directory = OutputRoot / CaseName;
+    const FString FilePath = Directory / (CaseName + (bGLTF ? TEXT(".glb") : TEXT(".obj")));
+
+    bool bSuccess = true;
+    for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+    {
+        IFileManager::Get().DeleteDirectory(*Directory, false, true);
+
+        // The process peak includes earlier cases, so memory is measured against what is in use right before the run
+        const int64 BaselineUsedPhysical = FMeshExportReport::GetUsedPhysical();
+        Exporter->MergeAndExportMeshes(FilePath, bGLTF);
+
+        const FMeshExportReport& Report = Exporter->LastExportReport;
+        if (!Report.bSuccess)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Benchmark case %s failed"), *CaseName);
+            bSuccess = false;
+            break;
+        }
+
+        if (Iteration == 0 || Report.TotalSeconds < OutResult.Seconds)
+        {
+            OutResult.Name = CaseName;
+            OutResult.Seconds = Report.TotalSeconds;
+            OutResult.VerticesWritten = Report.VerticesWritten;
+            OutResult.BytesWritten = GetDirectorySize(Directory);
+            OutResult.Stages = Report.Stages;
+            OutResult.PeakMemoryRise = FMath::Max<int64>(Report.MaxUsedPhysical - BaselineUsedPhysical, 0);
+        }
+
+        // Merged meshes of each run are only freed by a collection
+        CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+    }
+
+    Exporter->Destroy();
+
+    if (bSuccess)
+    {
+        UE_LOG(LogTemp, Display, TEXT("%s: %.3f s, %.0f vertices/s, %.1f MB/s, peak memory +%lld MB"), *CaseName, OutResult.Seconds,
+            OutResult.GetVerticesPerSecond(), OutResult.GetMegabytesPerSecond(), OutResult.PeakMemoryRise / (1024 * 1024));
+    }
+    return bSuccess;
+}
+
+static FString ResultsToJson(const TArray<FMeshExportBenchmarkResult>& Results)
+{
+    FString Text;
+    TSharedRef<TJsonWriter<>> Json = TJsonWriterFactory<>::Create(&Text);
+    Json->WriteObjectStart();
+    Json->WriteArrayStart(TEXT("cases"));
+    for (const FMeshExportBenchmarkResult& Result : Results)
+    {
+        Json->WriteObjectStart();
+        Json->WriteValue(TEXT("name"), Result.Name);
+        Json->WriteValue(TEXT("seconds"), Result.Seconds);
+        Json->WriteValue(TEXT("verticesWritten"), Result.VerticesWritten);
+        Json->WriteValue(TEXT("bytesWritten"), Result.BytesWritten);
+        Json->WriteValue(TEXT("verticesPerSecond"), Result.GetVerticesPerSecond());
+        Json->WriteValue(TEXT("megabytesPerSecond"), Result.GetMegabytesPerSecond());
+        Json->WriteValue(TEXT("peakMemoryRise"), Result.PeakMemoryRise);
+        Json->WriteObjectStart(TEXT("stages"));
+        for (const FMeshExportStageReport& Stage : Result.Stages)
+        {
+            Json->WriteValue(Stage.Name, Stage.Seconds);
+        }
+        Json->WriteObjectEnd();
+        Json->WriteObjectEnd();
+    }
+    Json->WriteArrayEnd();
+    Json->WriteObjectEnd();
+    Json->Close();
+    return Text;
+}
+
+// Case name to seconds from a results file written by a previous run
+static bool LoadBaseline(const FString& Path, TMap<FString, double>& OutSeconds)
+{
+    FString Text;
+    if (!FFileHelper::LoadFileToString(Text, *Path))
+    {
+        return false;
+    }
+
+    TSharedPtr<FJsonObject> Root;
+    if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Text), Root) || !Root.IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("Baseline is not valid JSON: %s"), *Path);
+        return false;
+    }
+
+    const TArray<TSharedPtr<FJsonValue>>* Cases = nullptr;
+    if (Root->TryGetArrayField(TEXT("cases"), Cases))
+    {
+        for (const TSharedPtr<FJsonValue>& Case : *Cases)
+        {
+            const TSharedPtr<FJsonObject>* CaseObject = nullptr;
+            if (Case->TryGetObject(CaseObject))
+            {
+                OutSeconds.Add((*CaseObject)->GetStringField(TEXT("name")), (*CaseObject)->GetNumberField(TEXT("seconds")));
+            }
+        }
+    }
+    return true;
+}
+#endif
+
+int32 UMeshExportBenchmarkCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+    const TArray<FString> ActorCounts = MeshExportCommandlet::ParseList(Params, TEXT("Actors="), TEXT(""));
+    const TArray<FString> Maps = MeshExportCommandlet::ParseList(Params, TEXT("Maps="), TEXT(""));
+    const TArray<FString> Modes = MeshExportCommandlet::ParseList(Params, TEXT("Modes="), TEXT("merged,direct"));
+    const TArray<FString> Formats = MeshExportCommandlet::ParseList(Params, TEXT("Formats="), TEXT("obj,glb"));
+
+    int32 NumMaterials = 8;
+    int32 NumTextures = 4;
+    int32 TextureSize = 1024;
+    int32 Iterations = 3;
+    float Tolerance = 0.1f;
+    FParse::Value(*Params, TEXT("Materials="), NumMaterials);
+    FParse::Value(*Params, TEXT("Textures="), NumTextures);
+    FParse::Value(*Params, TEXT("TextureSize="), TextureSize);
+    FParse::Value(*Params, TEXT("Iterations="), Iterations);
+    FParse::Value(*Params, TEXT("Tolerance="), Tolerance);
+    TextureSize = FMath::Max(TextureSize, 1);
+    Iterations = FMath::Max(Iterations, 1);
+
+    FString OutputRoot = FPaths::ProjectSavedDir() / TEXT("MeshExportBenchmark");
+    FParse::Value(*Params, TEXT("Output="), OutputRoot);
+
+    FString BaselinePath;
+    FParse::Value(*Params, TEXT("Baseline="), BaselinePath);
+    const bool bSaveBaseline = FParse::Param(*Params, TEXT("SaveBaseline"));
+
+    // Without a scene to load, a small and a medium grid are measured
+    TArray<FString> Scenes = ActorCounts;
+    if (Scenes.Num() == 0 && Maps.Num() == 0)
+    {
+        Scenes = { TEXT("100"), TEXT("1000") };
+    }
+    Scenes.Append(Maps);
+
+    TArray<FMeshExportBenchmarkResult> Results;
+    bool bAllSucceeded = true;
+    for (const FString& Scene : Scenes)
+    {
+        const bool bSynthetic = Scene.IsNumeric();
+        UWorld* World = bSynthetic
+            ? CreateSyntheticWorld(FCString::Atoi(*Scene), NumMaterials, NumTextures, TextureSize)
+            : MeshExportCommandlet::LoadWorld(Scene);
+        if (!World)
+        {
+            bAllSucceeded = false;
+            continue;
+        }
+
+        const FString SceneName = bSynthetic ? TEXT("Grid") + Scene : FPackageName::GetShortName(Scene);
+        for (const FString& Mode : Modes)
+        {
+            for (const FString& Format : Formats)
+            {
+                const FString CaseName = FString::Printf(TEXT("%s_%s_%s"), *SceneName, *Mode, *Format);
+                FMeshExportBenchmarkResult Result;
+                if (RunCase(World, CaseName, Mode != TEXT("direct"), Format == TEXT("glb"), Iterations, OutputRoot, Result))
+                {
+                    Results.Add(MoveTemp(Result));
+                }
+                else
+                {
+                    bAllSucceeded = false;
+                }
+            }
+        }
+
+        MeshExportCommandlet::DestroyWorld(World);
+    }
+
+    const FString ResultsText = ResultsToJson(Results);
+    const FString ResultsPath = OutputRoot / TEXT("benchmark_results.json");
+    if (FFileHelper::SaveStringToFile(ResultsText, *ResultsPath))
+    {
+        UE_LOG(LogTemp, Display, TEXT("Benchmark results saved to: %s"), *ResultsPath);
+    }
+
+    if (BaselinePath.IsEmpty())
+    {
+        return bAllSucceeded ? 0 : 1;
+    }
+
+    if (bSaveBaseline)
+    {
+        const bool bSaved = FFileHelper::SaveStringToFile(ResultsText, *BaselinePath);
+        UE_LOG(LogTemp, Display, TEXT("Baseline %s: %s"), bSaved ? TEXT("saved") : TEXT("could not be saved"), *BaselinePath);
+        return bAllSucceeded && bSaved ? 0 : 1;
+    }
+
+    TMap<FString, double> BaselineSeconds;
+    if (!LoadBaseline(BaselinePath, BaselineSeconds))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to read baseline: %s"), *BaselinePath);
+        return 1;
+    }
+
+    int32 NumRegressions = 0;
+    for (const FMeshExportBenchmarkResult& Result : Results)
+    {
+        const double* Baseline = BaselineSeconds.Find(Result.Name);
+        if (!Baseline || *Baseline <= 0.0)
+        {
+            UE_LOG(LogTemp, Display, TEXT("%s: %.3f s, not in the baseline"), *Result.Name, Result.Seconds);
+            continue;
+        }
+
+        const double Change = Result.Seconds / *Baseline - 1.0;
+        const bool bRegressed = Change > Tolerance;
+        NumRegressions += bRegressed ? 1 : 0;
+        UE_LOG(LogTemp, Display, TEXT("%s: %.3f s against %.3f s (%+.1f%%)%s"), *Result.Name, Result.Seconds, *Baseline,
+            Change * 100.0, bRegressed ? TEXT(" REGRESSION") : TEXT(""));
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("%d of %d cases slower than the baseline by more than %.0f%%"), NumRegressions, Results.Num(), Tolerance * 100.0f);
+    return bAllSucceeded && NumRegressions == 0 ? 0 : 1;
+#else
+    UE_LOG(LogTemp, Error, TEXT("The mesh export benchmark needs an editor build"));
+    return 1;
+#endif
+}
@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MeshExportBenchmarkCommandlet.generated.h"
+
+/**
+ * Measures AMeshMergerExporter on synthetic grids of static mesh actors and on recorded levels, in every requested
+ * mode and format, and compares the results with a stored baseline.
+ *
+ *   -run=MeshExportBenchmark [-Actors=100,1000] [-Materials=8] [-Textures=4] [-TextureSize=1024] [-Maps=/Game/A,/Game/B]
+ *       [-Modes=merged,direct] [-Formats=obj,glb] [-Iterations=3] [-Output=Dir] [-Baseline=File.json] [-SaveBaseline]
+ *       [-Tolerance=0.1]
+ *
+ * Each case keeps its fastest run. Results, with throughput, stage times and how far memory rose above what was in use
+ * before the run, are saved to benchmark_results.json in the output folder. With -Baseline, a case slower than the
+ * baseline by more than Tolerance makes the commandlet return 1; -SaveBaseline replaces the baseline with this run instead.
+ */
+UCLASS()
+class SAFRAN_APP_API UMeshExportBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UMeshExportBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
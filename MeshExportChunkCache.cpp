@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MeshExportChunkCache.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/SecureHash.h"
+
+static const TCHAR* ChunkExtension = TEXT(".objchunk");
+
+FMeshExportChunkCache::FMeshExportChunkCache(const FString& InDirectory)
+    : Directory(InDirectory)
+{
+    IFileManager::Get().MakeDirectory(*Directory, true);
+
+    TArray<FString> Files;
+    IFileManager::Get().FindFiles(Files, *Directory, ChunkExtension);
+    for (const FString& File : Files)
+    {
+        ExistingKeys.Add(FPaths::GetBaseFilename(File));
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Found %d cached geometry chunks in %s"), ExistingKeys.Num(), *Directory);
+}
+
+FString FMeshExportChunkCache::MakeKey(FStringView Description)
+{
+    FTCHARToUTF8 Utf8(Description.GetData(), Description.Len());
+    uint8 Hash[FSHA1::DigestSize];
+    FSHA1::HashBuffer(Utf8.Get(), Utf8.Length(), Hash);
+    return BytesToHex(Hash, FSHA1::DigestSize);
+}
+
+bool FMeshExportChunkCache::Contains(const FString& Key) const
+{
+    FScopeLock ScopeLock(&Lock);
+    return ExistingKeys.Contains(Key);
+}
+
+bool FMeshExportChunkCache::Load(const FString& Key, TArray<uint8>& OutData) const
+{
+    OutData.Reset();
+    return Contains(Key) && FFileHelper::LoadFileToArray(OutData, *GetChunkPath(Key), FILEREAD_Silent);
+}
+
+FString FMeshExportChunkCache::GetChunkPath(const FString& Key) const
+{
+    return Directory / (Key + ChunkExtension);
+}
+
+void FMeshExportChunkCache::MarkUsed(const FString& Key)
+{
+    FScopeLock ScopeLock(&Lock);
+    ExistingKeys.Add(Key);
+    UsedKeys.Add(Key);
+}
+
+void FMeshExportChunkCache::RemoveUnused()
+{
+    FScopeLock ScopeLock(&Lock);
+
+    int32 NumRemoved = 0;
+    for (auto It = ExistingKeys.CreateIterator(); It; ++It)
+    {
+        if (!UsedKeys.Contains(*It))
+        {
+            IFileManager::Get().Delete(*GetChunkPath(*It));
+            It.RemoveCurrent();
+            NumRemoved++;
+        }
+    }
+
+    if (NumRemoved > 0)
+    {
+        UE_LOG(LogTemp, Log, TEXT("Removed %d stale geometry chunks from %s"), NumRemoved, *Directory);
+    }
+}
@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+/**
+ * Folder of OBJ object chunks kept from previous exports, one file per instance named after a hash of everything that
+ * went into it. A re-export copies the chunks whose key is still the same instead of formatting those instances again.
+ * Lookups and MarkUsed can be called from any thread once constructed.
+ */
+class SAFRAN_APP_API FMeshExportChunkCache
+{
+public:
+	/** Creates Directory if needed and lists the chunks already in it. */
+	explicit FMeshExportChunkCache(const FString& InDirectory);
+
+	/** Hex hash of Description, used as the chunk file name. */
+	static FString MakeKey(FStringView Description);
+
+	bool Contains(const FString& Key) const;
+
+	/** Reads the chunk of Key into OutData. Returns false if it is not in the cache or could not be read. */
+	bool Load(const FString& Key, TArray<uint8>& OutData) const;
+
+	FString GetChunkPath(const FString& Key) const;
+	const FString& GetDirectory() const { return Directory; }
+
+	/** Records that the current export uses the chunk, whether it was reused or just written. */
+	void MarkUsed(const FString& Key);
+
+	/** Deletes the chunks the current export did not use, so the folder only holds the last export. */
+	void RemoveUnused();
+
+private:
+	FString Directory;
+	TSet<FString> ExistingKeys;
+	TSet<FString> UsedKeys;
+	mutable FCriticalSection Lock;
+};
@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MeshExportCommandletUtils.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+TArray<FString> MeshExportCommandlet::ParseList(const FString& Params, const TCHAR* Name, const TCHAR* Default)
+{
+    FString Text = Default;
+    FParse::Value(*Params, Name, Text, false);
+
+    TArray<FString> Items;
+    Text.ParseIntoArray(Items, TEXT(","));
+    return Items;
+}
+
+bool MeshExportCommandlet::LoadMapList(const FString& FilePath, TArray<FString>& OutMaps)
+{
+    TArray<FString> Lines;
+    if (!FFileHelper::LoadFileToStringArray(Lines, *FilePath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to read map list: %s"), *FilePath);
+        return false;
+    }
+
+    for (FString& Line : Lines)
+    {
+        Line.TrimStartAndEndInline();
+        if (!Line.IsEmpty() && !Line.StartsWith(TEXT("#")))
+        {
+            OutMaps.Add(MoveTemp(Line));
+        }
+    }
+    return true;
+}
+
+#if WITH_EDITOR
+void MeshExportCommandlet::AddWorldContext(UWorld* World)
+{
+    FWorldContext& Context = GEngine->CreateNewWorldContext(EWorldType::Editor);
+    Context.SetCurrentWorld(World);
+}
+
+UWorld* MeshExportCommandlet::LoadWorld(const FString& MapPath)
+{
+    UPackage* Package = LoadPackage(nullptr, *MapPath, LOAD_None);
+    UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+    if (!World)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to load map: %s"), *MapPath);
+        return nullptr;
+    }
+
+    World->AddToRoot();
+    World->WorldType = EWorldType::Editor;
+    AddWorldContext(World);
+    if (!World->bIsWorldInitialized)
+    {
+        World->InitWorld(UWorld::InitializationValues()
+            .AllowAudioPlayback(false)
+            .CreatePhysicsScene(false)
+            .CreateNavigation(false)
+            .CreateAISystem(false)
+            .ShouldSimulatePhysics(false)
+            .RequiresHitProxies(false)
+            .SetTransactional(false));
+    }
+    World->UpdateWorldComponents(true, false);
+    return World;
+}
+
+void MeshExportCommandlet::DestroyWorld(UWorld* World)
+{
+    GEngine->DestroyWorldContext(World);
+    World->DestroyWorld(false);
+    World->RemoveFromRoot();
+    CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+#endif
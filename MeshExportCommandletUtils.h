@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+/** Helpers shared by the mesh export commandlets. */
+namespace MeshExportCommandlet
+{
+	/** Splits the comma separated value of a -Name= parameter, or of Default when the parameter is missing. */
+	SAFRAN_APP_API TArray<FString> ParseList(const FString& Params, const TCHAR* Name, const TCHAR* Default);
+
+	/** Reads a list of maps, one per line. Empty lines and lines starting with # are skipped. */
+	SAFRAN_APP_API bool LoadMapList(const FString& FilePath, TArray<FString>& OutMaps);
+
+#if WITH_EDITOR
+	/** Registers World with the engine as an editor world, so actors can be spawned and found in it. */
+	SAFRAN_APP_API void AddWorldContext(UWorld* World);
+
+	/**
+	 * Loads the persistent level of a map, initialized without physics, audio or navigation. Streamed levels and
+	 * world partition cells are not loaded. Returns null if the map could not be loaded.
+	 */
+	SAFRAN_APP_API UWorld* LoadWorld(const FString& MapPath);
+
+	/** Tears down a world from LoadWorld or one created with AddWorldContext, and collects its objects. */
+	SAFRAN_APP_API void DestroyWorld(UWorld* World);
+#endif
+}
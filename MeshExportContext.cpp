@@ -0,0 +1,140 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MeshExportContext.h"
+#include "IImageWrapperModule.h"
+#include "Modules/ModuleManager.h"
+#include "Misc/ScopeLock.h"
+
+static FCriticalSection GCurrentContextLock;
+static TSharedPtr<FMeshExportContext, ESPMode::ThreadSafe> GCurrentContext;
+
+FMeshExportContext::FMeshExportContext()
+{
+    check(IsInGameThread());
+    ImageWrapperModule = &FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+}
+
+TSharedPtr<FMeshExportContext, ESPMode::ThreadSafe> FMeshExportContext::Get()
+{
+    FScopeLock ScopeLock(&GCurrentContextLock);
+    return GCurrentContext;
+}
+
+void FMeshExportContext::SetCurrent(TSharedPtr<FMeshExportContext, ESPMode::ThreadSafe> Context)
+{
+    FScopeLock ScopeLock(&GCurrentContextLock);
+    GCurrentContext = MoveTemp(Context);
+}
+
+TArray64<uint8> FMeshExportContext::AcquirePixelBuffer(int64 NumBytes)
+{
+    {
+        FScopeLock ScopeLock(&Lock);
+
+        // The smallest buffer that is large enough, so big ones stay available for big textures
+        int32 BestIndex = INDEX_NONE;
+        for (int32 Index = 0; Index < PixelBuffers.Num(); Index++)
+        {
+            if (PixelBuffers[Index].Max() >= NumBytes && (BestIndex == INDEX_NONE || PixelBuffers[Index].Max() < PixelBuffers[BestIndex].Max()))
+            {
+                BestIndex = Index;
+            }
+        }
+
+        if (BestIndex != INDEX_NONE)
+        {
+            TArray64<uint8> Buffer = MoveTemp(PixelBuffers[BestIndex]);
+            PixelBuffers.RemoveAtSwap(BestIndex);
+            PooledBytes -= Buffer.GetAllocatedSize();
+            return Buffer;
+        }
+    }
+
+    TArray64<uint8> Buffer;
+    Buffer.Reserve(NumBytes);
+    return Buffer;
+}
+
+void FMeshExportContext::ReleasePixelBuffer(TArray64<uint8>&& Buffer)
+{
+    const int64 Size = Buffer.GetAllocatedSize();
+    if (Size == 0)
+    {
+        return;
+    }
+
+    FScopeLock ScopeLock(&Lock);
+    if (PooledBytes + Size <= MaxPooledBytes)
+    {
+        Buffer.Reset();
+        PixelBuffers.Add(MoveTemp(Buffer));
+        PooledBytes += Size;
+    }
+}
+
+FMeshExportTextBuffer FMeshExportContext::AcquireTextBuffer()
+{
+    FScopeLock ScopeLock(&Lock);
+    if (TextBuffers.Num() == 0)
+    {
+        return FMeshExportTextBuffer();
+    }
+
+    FMeshExportTextBuffer Buffer = TextBuffers.Pop(false);
+    PooledBytes -= Buffer.GetCapacity();
+    return Buffer;
+}
+
+void FMeshExportContext::ReleaseTextBuffer(FMeshExportTextBuffer&& Buffer)
+{
+    const int64 Size = Buffer.GetCapacity();
+    if (Size == 0)
+    {
+        return;
+    }
+
+    FScopeLock ScopeLock(&Lock);
+    if (PooledBytes + Size <= MaxPooledBytes)
+    {
+        Buffer.Reset();
+        TextBuffers.Add(MoveTemp(Buffer));
+        PooledBytes += Size;
+    }
+}
+
+void FMeshExportContext::Trim()
+{
+    FScopeLock ScopeLock(&Lock);
+    PixelBuffers.Empty();
+    TextBuffers.Empty();
+    PooledBytes = 0;
+}
+
+int64 FMeshExportContext::GetPooledBytes() const
+{
+    FScopeLock ScopeLock(&Lock);
+    return PooledBytes;
+}
+
+void FMeshExportContext::SetMaxPooledBytes(int64 InMaxPooledBytes)
+{
+    FScopeLock ScopeLock(&Lock);
+    MaxPooledBytes = FMath::Max<int64>(InMaxPooledBytes, 0);
+}
+
+FMeshExportScopedPixelBuffer::FMeshExportScopedPixelBuffer(FMeshExportContext* InContext, int64 NumBytes)
+    : Context(InContext)
+{
+    if (Context)
+    {
+        Buffer = Context->AcquirePixelBuffer(NumBytes);
+    }
+}
+
+FMeshExportScopedPixelBuffer::~FMeshExportScopedPixelBuffer()
+{
+    if (Context)
+    {
+        Context->ReleasePixelBuffer(MoveTemp(Buffer));
+    }
+}
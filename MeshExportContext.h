@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "MeshExportWriter.h"
+
+class IImageWrapperModule;
+
+/**
+ * State kept between exports: the image wrapper module and pools of the pixel and text buffers that every export
+ * would otherwise allocate again at full size. UMeshExportSubsystem owns the context of the running engine; exports
+ * work without one, allocating as they go. The pools can be used from any thread.
+ */
+class SAFRAN_APP_API FMeshExportContext
+{
+public:
+	static constexpr int64 DefaultMaxPooledBytes = 256ll * 1024 * 1024;
+
+	/** Loads the image wrapper module, so this has to be constructed on the game thread. */
+	FMeshExportContext();
+
+	/** The context of the running engine, null before UMeshExportSubsystem started or once it shut down. Any thread. */
+	static TSharedPtr<FMeshExportContext, ESPMode::ThreadSafe> Get();
+
+	/** Makes Context the one Get returns; called by the subsystem. */
+	static void SetCurrent(TSharedPtr<FMeshExportContext, ESPMode::ThreadSafe> Context);
+
+	IImageWrapperModule& GetImageWrapperModule() const { return *ImageWrapperModule; }
+
+	/** An empty pixel buffer with room for at least NumBytes, reusing a pooled allocation when one is large enough. */
+	TArray64<uint8> AcquirePixelBuffer(int64 NumBytes);
+
+	/** Hands a buffer back to the pool, or frees it if the pool is full. */
+	void ReleasePixelBuffer(TArray64<uint8>&& Buffer);
+
+	/** A text buffer keeping the allocation of one used before, when there is one. */
+	FMeshExportTextBuffer AcquireTextBuffer();
+	void ReleaseTextBuffer(FMeshExportTextBuffer&& Buffer);
+
+	/** Frees everything pooled. */
+	void Trim();
+
+	/** Bytes held by the pools; buffers in use are not counted. */
+	int64 GetPooledBytes() const;
+
+	/** Buffers handed back while the pools hold this much are freed instead. */
+	void SetMaxPooledBytes(int64 InMaxPooledBytes);
+
+private:
+	IImageWrapperModule* ImageWrapperModule = nullptr;
+
+	TArray<TArray64<uint8>> PixelBuffers;
+	TArray<FMeshExportTextBuffer> TextBuffers;
+	int64 PooledBytes = 0;
+	int64 MaxPooledBytes = DefaultMaxPooledBytes;
+	mutable FCriticalSection Lock;
+};
+
+/** Pixel buffer taken from a context's pool for the length of a scope, or a plain array when Context is null. */
+class SAFRAN_APP_API FMeshExportScopedPixelBuffer
+{
+public:
+	FMeshExportScopedPixelBuffer(FMeshExportContext* InContext, int64 NumBytes);
+	~FMeshExportScopedPixelBuffer();
+
+	FMeshExportScopedPixelBuffer(const FMeshExportScopedPixelBuffer&) = delete;
+	FMeshExportScopedPixelBuffer& operator=(const FMeshExportScopedPixelBuffer&) = delete;
+
+	TArray64<uint8>& Get() { return Buffer; }
+
+private:
+	FMeshExportContext* Context;
+	TArray64<uint8> Buffer;
+};
@@ -0,0 +1,824 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MeshExportGLBWriter.h"
+#include "MeshExportMeshData.h"
+#include "MeshExportTypes.h"
+#include "MeshExportWriter.h"
+#include "MeshExportReport.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonWriter.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+
+// GLB container constants, see the glTF 2.0 specification
+static constexpr uint32 GLBMagic = 0x46546C67; // "glTF"
+static constexpr uint32 GLBVersion = 2;
+static constexpr uint32 GLBChunkJSON = 0x4E4F534A; // "JSON"
+static constexpr uint32 GLBChunkBIN = 0x004E4942; // "BIN\0"
+
+// Accessor component types, buffer view targets and primitive modes
+static constexpr int32 GLTFByte = 5120;
+static constexpr int32 GLTFShort = 5122;
+static constexpr int32 GLTFUnsignedShort = 5123;
+static constexpr int32 GLTFUnsignedInt = 5125;
+static constexpr int32 GLTFFloat = 5126;
+static constexpr int32 GLTFArrayBuffer = 34962;
+static constexpr int32 GLTFElementArrayBuffer = 34963;
+static constexpr int32 GLTFTriangles = 4;
+
+// glTF units are meters, Unreal units centimeters
+static constexpr float CentimetersToMeters = 0.01f;
+
+using FGLTFJsonWriter = TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>;
+using FGLTFJsonWriterFactory = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>;
+
+// Same axis swap as the OBJ writer (Z-up to Y-up), so both formats line up
+static FVector3f ToGLTFPosition(const FVector3f& Position)
+{
+    return FVector3f(Position.X, Position.Z, Position.Y) * CentimetersToMeters;
+}
+
+static FVector3f ToGLTFNormal(const FVector3f& Normal)
+{
+    // glTF requires unit length normals; vertices without a usable normal point up
+    const FVector3f Converted = FVector3f(Normal.X, Normal.Z, Normal.Y).GetSafeNormal();
+    return Converted.IsZero() ? FVector3f(0.0f, 1.0f, 0.0f) : Converted;
+}
+
+static int64 AlignTo4(int64 Value)
+{
+    return (Value + 3) & ~3ll;
+}
+
+// Largest value of a signed Bits-bit integer grid
+static int32 GetQuantizationMax(int32 Bits)
+{
+    return (1 << (Bits - 1)) - 1;
+}
+
+// Snaps Value to a grid of GridMax steps per unit and stores it as a normalized integer whose 1.0 is TypeMax
+static int32 QuantizeNormalized(float Value, int32 GridMax, int32 TypeMax)
+{
+    const double Snapped = FMath::RoundToDouble(static_cast<double>(Value) * GridMax) / GridMax;
+    return static_cast<int32>(FMath::RoundToDouble(Snapped * TypeMax));
+}
+
+static const TCHAR* GetImageMimeType(const FString& FilePath)
+{
+    const FString Extension = FPaths::GetExtension(FilePath).ToLower();
+    if (Extension == TEXT("png"))
+    {
+        return TEXT("image/png");
+    }
+    if (Extension == TEXT("jpg") || Extension == TEXT("jpeg"))
+    {
+        return TEXT("image/jpeg");
+    }
+    return nullptr;
+}
+
+// A range of the BIN chunk
+struct FGLBBufferView
+{
+    int64 Offset = 0;
+    int64 Length = 0;
+    int32 Target = 0;
+    int32 ByteStride = 0;
+};
+
+// Image used by one or more materials, loaded up front when it is embedded
+struct FGLBImage
+{
+    FString URI;
+    const TCHAR* MimeType = nullptr;
+    TArray<uint8> Bytes;
+    int32 BufferView = INDEX_NONE;
+};
+
+// Where the data of one mesh goes in the BIN chunk, the accessor list and the mesh list
+struct FGLBMeshLayout
+{
+    int32 GLTFMesh = INDEX_NONE;
+    int32 PositionView = INDEX_NONE;
+    int32 NormalView = INDEX_NONE;
+    int32 UVView = INDEX_NONE;
+    TArray<int32> SectionViews;
+    int32 FirstAccessor = 0;
+    bool bShortIndices = false;
+    FBox3f Bounds = FBox3f(ForceInit);
+
+    // Quantized positions are (Position - QuantizationCenter) / QuantizationStep; UVs are only quantized inside 0-1
+    FVector3f QuantizationCenter = FVector3f::ZeroVector;
+    float QuantizationStep = 1.0f;
+    bool bQuantizedUVs = false;
+};
+
+// Unreal transform with the same axis swap and unit change as ToGLTFPosition applied on both sides,
+// so mesh data converted with ToGLTFPosition ends up where the transform puts it
+static FMatrix ToGLTFMatrix(const FMatrix& Transform)
+{
+    static constexpr int32 SwapYZ[4] = { 0, 2, 1, 3 };
+
+    FMatrix Result;
+    for (int32 Row = 0; Row < 4; Row++)
+    {
+        for (int32 Column = 0; Column < 4; Column++)
+        {
+            Result.M[Row][Column] = Transform.M[SwapYZ[Row]][SwapYZ[Column]];
+            if (Row == 3 && Column < 3)
+            {
+                Result.M[Row][Column] *= CentimetersToMeters;
+            }
+        }
+    }
+    return Result;
+}
+
+// Written column-major, which is the row-major layout of Unreal's row-vector matrices
+static void WriteNodeMatrix(FGLTFJsonWriter& Json, const FMatrix& Matrix)
+{
+    Json.WriteArrayStart(TEXT("matrix"));
+    for (int32 Row = 0; Row < 4; Row++)
+    {
+        for (int32 Column = 0; Column < 4; Column++)
+        {
+            Json.WriteValue(Matrix.M[Row][Column]);
+        }
+    }
+    Json.WriteArrayEnd();
+}
+
+static bool WriteGLB(TConstArrayView<FMeshExportMeshData> Meshes, TConstArrayView<FMeshExportInstance> Instances,
+    TConstArrayView<FMeshExportGLBMaterial> Materials, const FString& FilePath, const FMeshExportSettings& Settings, FMeshExportProgress* Progress,
+    FMeshExportReport* Report)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_STR(TEXT("Write GLB"));
+    FMeshExportStageTimer WriteTimer(Report, TEXT("Write GLB"), nullptr, true);
+
+    // Each mesh is written once; nodes reference it with their transform
+    int64 TotalWedges = 0;
+    int64 TotalTriangles = 0;
+    for (const FMeshExportMeshData& Data : Meshes)
+    {
+        TotalWedges += Data.NumWedges();
+        TotalTriangles += Data.NumTriangles();
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Exporting %d meshes (%lld vertices, %lld triangles) in %d nodes to GLB"),
+        Meshes.Num(), TotalWedges, TotalTriangles, Instances.Num());
+
+    if (TotalTriangles == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Nothing to export to: %s"), *FilePath);
+        return false;
+    }
+
+    // KHR_mesh_quantization: integer positions scaled back by the node matrix, normals and UVs as normalized integers.
+    // Quantized VEC3 elements are padded to 4 byte boundaries as glTF requires for vertex attributes.
+    const bool bQuantize = Settings.bQuantizeGeometry;
+    const int32 PositionGridMax = GetQuantizationMax(FMath::Clamp(Settings.PositionQuantizationBits, 8, 16));
+    const int32 NormalBits = FMath::Clamp(Settings.NormalQuantizationBits, 4, 16);
+    const int32 NormalGridMax = GetQuantizationMax(NormalBits);
+    const bool bByteNormals = NormalBits <= 8;
+    const int32 UVGridMax = (1 << FMath::Clamp(Settings.UVQuantizationBits, 8, 16)) - 1;
+
+    const int32 PositionStride = bQuantize ? 4 * sizeof(int16) : sizeof(FVector3f);
+    const int32 NormalStride = bQuantize ? (bByteNormals ? 4 * sizeof(int8) : 4 * sizeof(int16)) : sizeof(FVector3f);
+
+    // Lay out the BIN chunk: per mesh the vertex streams and one index view per non-empty section, then embedded images
+    TArray<FGLBBufferView> BufferViews;
+    int64 BinLength = 0;
+    auto AddBufferView = [&BufferViews, &BinLength](int64 Length, int32 Target, int32 ByteStride = 0)
+    {
+        FGLBBufferView& View = BufferViews.AddDefaulted_GetRef();
+        View.Offset = BinLength;
+        View.Length = Length;
+        View.Target = Target;
+        View.ByteStride = ByteStride;
+        BinLength = AlignTo4(BinLength + Length);
+        return BufferViews.Num() - 1;
+    };
+
+    // Meshes without triangles are left out, along with their nodes; they would make invalid glTF meshes
+    TArray<FGLBMeshLayout> Layouts;
+    Layouts.SetNum(Meshes.Num());
+    TArray<int32> WrittenMeshes;
+    int32 NumAccessors = 0;
+    for (int32 MeshIndex = 0; MeshIndex < Meshes.Num(); MeshIndex++)
+    {
+        const FMeshExportMeshData& Data = Meshes[MeshIndex];
+        const int32 NumWedges = Data.NumWedges();
+        if (NumWedges == 0 || Data.NumTriangles() == 0)
+        {
+            continue;
+        }
+
+        FGLBMeshLayout& Layout = Layouts[MeshIndex];
+        Layout.GLTFMesh = WrittenMeshes.Add(MeshIndex);
+
+        // 16-bit indices when every wedge fits; the largest value of the index type is not allowed
+        Layout.bShortIndices = NumWedges < MAX_uint16;
+        const int32 IndexSize = Layout.bShortIndices ? sizeof(uint16) : sizeof(uint32);
+
+        // POSITION needs its bounds in the JSON, taken from the exact values that get written
+        for (int32 Wedge = 0; Wedge < NumWedges; ++Wedge)
+        {
+            Layout.Bounds += ToGLTFPosition(Data.Positions[Data.WedgePositions[Wedge]]);
+        }
+
+        if (bQuantize)
+        {
+            // One scale for all axes, so the dequantization in the node matrix leaves normals alone
+            const float HalfSize = Layout.Bounds.GetExtent().GetMax();
+            Layout.QuantizationCenter = Layout.Bounds.GetCenter();
+            Layout.QuantizationStep = HalfSize > 0.0f ? HalfSize / PositionGridMax : 1.0f;
+
+            // Normalized UVs cannot leave 0-1 without KHR_texture_transform, such meshes keep float UVs
+            Layout.bQuantizedUVs = !Data.WedgeUVs.ContainsByPredicate([](const FVector2f& UV)
+            {
+                return UV.X < 0.0f || UV.X > 1.0f || UV.Y < 0.0f || UV.Y > 1.0f;
+            });
+        }
+
+        const int32 UVStride = Layout.bQuantizedUVs ? 2 * sizeof(uint16) : sizeof(FVector2f);
+        Layout.PositionView = AddBufferView(static_cast<int64>(NumWedges) * PositionStride, GLTFArrayBuffer, bQuantize ? PositionStride : 0);
+        Layout.NormalView = AddBufferView(static_cast<int64>(NumWedges) * NormalStride, GLTFArrayBuffer, bQuantize ? NormalStride : 0);
+        Layout.UVView = AddBufferView(static_cast<int64>(NumWedges) * UVStride, GLTFArrayBuffer);
+
+        // Accessors per mesh: the three vertex streams, then the index accessors in section order
+        Layout.FirstAccessor = NumAccessors;
+        NumAccessors += 3;
+
+        Layout.SectionViews.Init(INDEX_NONE, Data.Sections.Num());
+        for (int32 SectionIndex = 0; SectionIndex < Data.Sections.Num(); SectionIndex++)
+        {
+            const int32 NumIndices = Data.Sections[SectionIndex].Indices.Num() / 3 * 3;
+            if (NumIndices > 0)
+            {
+                Layout.SectionViews[SectionIndex] = AddBufferView(static_cast<int64>(NumIndices) * IndexSize, GLTFElementArrayBuffer);
+                NumAccessors++;
+            }
+        }
+    }
+
+    auto QuantizePosition = [PositionGridMax](const FGLBMeshLayout& Layout, const FVector3f& Position)
+    {
+        const FVector3f Scaled = (Position - Layout.QuantizationCenter) / Layout.QuantizationStep;
+        return FIntVector(
+            FMath::Clamp(FMath::RoundToInt32(Scaled.X), -PositionGridMax, PositionGridMax),
+            FMath::Clamp(FMath::RoundToInt32(Scaled.Y), -PositionGridMax, PositionGridMax),
+            FMath::Clamp(FMath::RoundToInt32(Scaled.Z), -PositionGridMax, PositionGridMax));
+    };
+
+    // Sections find their material by name; materials sharing an image share one glTF image and texture
+    TMap<FString, int32> NameToMaterial;
+    TArray<FGLBImage> Images;
+    TMap<FString, int32> PathToImage;
+    // Image of each channel of each material, MeshExportNumMaterialChannels entries per material
+    TArray<int32> MaterialImages;
+    MaterialImages.Init(INDEX_NONE, Materials.Num() * MeshExportNumMaterialChannels);
+    for (int32 MaterialIndex = 0; MaterialIndex < Materials.Num(); MaterialIndex++)
+    {
+        const FMeshExportGLBMaterial& Material = Materials[MaterialIndex];
+        NameToMaterial.FindOrAdd(Material.Name, MaterialIndex);
+        for (int32 Channel = 0; Channel < MeshExportNumMaterialChannels; Channel++)
+        {
+            const FString& TexturePath = Material.TexturePaths[Channel];
+            int32& MaterialImage = MaterialImages[MaterialIndex * MeshExportNumMaterialChannels + Channel];
+            if (TexturePath.IsEmpty())
+            {
+                continue;
+            }
+
+            if (const int32* ExistingImage = PathToImage.Find(TexturePath))
+            {
+                MaterialImage = *ExistingImage;
+                continue;
+            }
+
+            const TCHAR* MimeType = GetImageMimeType(TexturePath);
+            if (!MimeType)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("glTF only supports PNG and JPEG images, skipping texture: %s"), *TexturePath);
+                continue;
+            }
+
+            FGLBImage Image;
+            Image.URI = Material.TextureURIs[Channel];
+            Image.MimeType = MimeType;
+            if (Settings.bEmbedTextures)
+            {
+                if (!FFileHelper::LoadFileToArray(Image.Bytes, *TexturePath) || Image.Bytes.Num() == 0)
+                {
+                    UE_LOG(LogTemp, Warning, TEXT("Failed to read texture for embedding: %s"), *TexturePath);
+                    continue;
+                }
+                Image.BufferView = AddBufferView(Image.Bytes.Num(), 0);
+            }
+
+            MaterialImage = Images.Add(MoveTemp(Image));
+            PathToImage.Add(TexturePath, MaterialImage);
+        }
+    }
+
+    FString JsonText;
+    TSharedRef<FGLTFJsonWriter> Json = FGLTFJsonWriterFactory::Create(&JsonText);
+    Json->WriteObjectStart();
+
+    Json->WriteObjectStart(TEXT("asset"));
+    Json->WriteValue(TEXT("version"), TEXT("2.0"));
+    Json->WriteValue(TEXT("generator"), TEXT("Unreal Engine 5 MeshMergerExporter"));
+    Json->WriteObjectEnd();
+
+    if (bQuantize)
+    {
+        Json->WriteArrayStart(TEXT("extensionsUsed"));
+        Json->WriteValue(TEXT("KHR_mesh_quantization"));
+        Json->WriteArrayEnd();
+        Json->WriteArrayStart(TEXT("extensionsRequired"));
+        Json->WriteValue(TEXT("KHR_mesh_quantization"));
+        Json->WriteArrayEnd();
+    }
+
+    // One node per instance whose mesh is written
+    TArray<int32> WrittenInstances;
+    for (int32 InstanceIndex = 0; InstanceIndex < Instances.Num(); InstanceIndex++)
+    {
+        if (Layouts[Instances[InstanceIndex].MeshIndex].GLTFMesh != INDEX_NONE)
+        {
+            WrittenInstances.Add(InstanceIndex);
+        }
+    }
+
+    Json->WriteValue(TEXT("scene"), 0);
+    Json->WriteArrayStart(TEXT("scenes"));
+    Json->WriteObjectStart();
+    Json->WriteArrayStart(TEXT("nodes"));
+    for (int32 NodeIndex = 0; NodeIndex < WrittenInstances.Num(); NodeIndex++)
+    {
+        Json->WriteValue(NodeIndex);
+    }
+    Json->WriteArrayEnd();
+    Json->WriteObjectEnd();
+    Json->WriteArrayEnd();
+
+    Json->WriteArrayStart(TEXT("nodes"));
+    for (const int32 InstanceIndex : WrittenInstances)
+    {
+        const FMeshExportInstance& Instance = Instances[InstanceIndex];
+        Json->WriteObjectStart();
+        Json->WriteValue(TEXT("name"), Instance.Name);
+        Json->WriteValue(TEXT("mesh"), Layouts[Instance.MeshIndex].GLTFMesh);
+
+        // glTF viewers flip the winding of nodes with a mirroring matrix themselves
+        if (bQuantize)
+        {
+            // Quantized positions are scaled and moved back into place before the instance transform
+            const FGLBMeshLayout& Layout = Layouts[Instance.MeshIndex];
+            const FMatrix Dequantization = FScaleMatrix(FVector(Layout.QuantizationStep)) * FTranslationMatrix(FVector(Layout.QuantizationCenter));
+            WriteNodeMatrix(*Json, Instance.bIsIdentity ? Dequantization : Dequantization * ToGLTFMatrix(Instance.Transform));
+        }
+        else if (!Instance.bIsIdentity)
+        {
+            WriteNodeMatrix(*Json, ToGLTFMatrix(Instance.Transform));
+        }
+        Json->WriteObjectEnd();
+    }
+    Json->WriteArrayEnd();
+
+    Json->WriteArrayStart(TEXT("meshes"));
+    for (const int32 MeshIndex : WrittenMeshes)
+    {
+        const FMeshExportMeshData& Data = Meshes[MeshIndex];
+        const FGLBMeshLayout& Layout = Layouts[MeshIndex];
+
+        Json->WriteObjectStart();
+        Json->WriteValue(TEXT("name"), Data.Name);
+        Json->WriteArrayStart(TEXT("primitives"));
+        int32 NextIndexAccessor = Layout.FirstAccessor + 3;
+        for (int32 SectionIndex = 0; SectionIndex < Data.Sections.Num(); SectionIndex++)
+        {
+            if (Layout.SectionViews[SectionIndex] == INDEX_NONE)
+            {
+                continue;
+            }
+
+            Json->WriteObjectStart();
+            Json->WriteObjectStart(TEXT("attributes"));
+            Json->WriteValue(TEXT("POSITION"), Layout.FirstAccessor);
+            Json->WriteValue(TEXT("NORMAL"), Layout.FirstAccessor + 1);
+            Json->WriteValue(TEXT("TEXCOORD_0"), Layout.FirstAccessor + 2);
+            Json->WriteObjectEnd();
+            Json->WriteValue(TEXT("indices"), NextIndexAccessor++);
+            if (const int32* MaterialIndex = NameToMaterial.Find(Data.Sections[SectionIndex].MaterialName))
+            {
+                Json->WriteValue(TEXT("material"), *MaterialIndex);
+            }
+            Json->WriteValue(TEXT("mode"), GLTFTriangles);
+            Json->WriteObjectEnd();
+        }
+        Json->WriteArrayEnd();
+        Json->WriteObjectEnd();
+    }
+    Json->WriteArrayEnd();
+
+    if (Materials.Num() > 0)
+    {
+        // Textures map one to one to images
+        auto WriteTextureInfo = [&Json](const TCHAR* Name, int32 ImageIndex)
+        {
+            if (ImageIndex != INDEX_NONE)
+            {
+                Json->WriteObjectStart(Name);
+                Json->WriteValue(TEXT("index"), ImageIndex);
+                Json->WriteObjectEnd();
+            }
+        };
+
+        Json->WriteArrayStart(TEXT("materials"));
+        for (int32 MaterialIndex = 0; MaterialIndex < Materials.Num(); MaterialIndex++)
+        {
+            const int32* Channels = &MaterialImages[MaterialIndex * MeshExportNumMaterialChannels];
+            const int32 RoughnessImage = Channels[static_cast<int32>(EMeshExportMaterialChannel::Roughness)];
+            const int32 MetallicImage = Channels[static_cast<int32>(EMeshExportMaterialChannel::Metallic)];
+            const int32 EmissiveImage = Channels[static_cast<int32>(EMeshExportMaterialChannel::Emissive)];
+
+            Json->WriteObjectStart();
+            Json->WriteValue(TEXT("name"), Materials[MaterialIndex].Name);
+            Json->WriteObjectStart(TEXT("pbrMetallicRoughness"));
+            WriteTextureInfo(TEXT("baseColorTexture"), Channels[static_cast<int32>(EMeshExportMaterialChannel::BaseColor)]);
+
+            // glTF reads roughness from green and metalness from blue, the layout of packed ORM textures. A lone
+            // roughness texture is grayscale so green works too, but its blue is not metalness, which stays off.
+            WriteTextureInfo(TEXT("metallicRoughnessTexture"), RoughnessImage);
+            Json->WriteValue(TEXT("metallicFactor"), RoughnessImage != INDEX_NONE && RoughnessImage == MetallicImage ? 1.0 : 0.0);
+            Json->WriteValue(TEXT("roughnessFactor"), 1.0);
+            Json->WriteObjectEnd();
+
+            WriteTextureInfo(TEXT("normalTexture"), Channels[static_cast<int32>(EMeshExportMaterialChannel::Normal)]);
+            WriteTextureInfo(TEXT("occlusionTexture"), Channels[static_cast<int32>(EMeshExportMaterialChannel::Occlusion)]);
+            if (EmissiveImage != INDEX_NONE)
+            {
+                // The factor defaults to black, which would switch the texture off
+                WriteTextureInfo(TEXT("emissiveTexture"), EmissiveImage);
+                Json->WriteArrayStart(TEXT("emissiveFactor"));
+                Json->WriteValue(1.0);
+                Json->WriteValue(1.0);
+                Json->WriteValue(1.0);
+                Json->WriteArrayEnd();
+            }
+            Json->WriteObjectEnd();
+        }
+        Json->WriteArrayEnd();
+    }
+
+    if (Images.Num() > 0)
+    {
+        Json->WriteArrayStart(TEXT("samplers"));
+        Json->WriteObjectStart();
+        Json->WriteObjectEnd();
+        Json->WriteArrayEnd();
+
+        Json->WriteArrayStart(TEXT("textures"));
+        for (int32 ImageIndex = 0; ImageIndex < Images.Num(); ImageIndex++)
+        {
+            Json->WriteObjectStart();
+            Json->WriteValue(TEXT("sampler"), 0);
+            Json->WriteValue(TEXT("source"), ImageIndex);
+            Json->WriteObjectEnd();
+        }
+        Json->WriteArrayEnd();
+
+        Json->WriteArrayStart(TEXT("images"));
+        for (const FGLBImage& Image : Images)
+        {
+            Json->WriteObjectStart();
+            if (Image.BufferView != INDEX_NONE)
+            {
+                Json->WriteValue(TEXT("bufferView"), Image.BufferView);
+                Json->WriteValue(TEXT("mimeType"), Image.MimeType);
+            }
+            else
+            {
+                Json->WriteValue(TEXT("uri"), Image.URI);
+            }
+            Json->WriteObjectEnd();
+        }
+        Json->WriteArrayEnd();
+    }
+
+    Json->WriteArrayStart(TEXT("accessors"));
+    for (const int32 MeshIndex : WrittenMeshes)
+    {
+        const FMeshExportMeshData& Data = Meshes[MeshIndex];
+        const FGLBMeshLayout& Layout = Layouts[MeshIndex];
+
+        auto WriteVertexAccessor = [&Json, &Data](int32 BufferView, const TCHAR* Type, int32 ComponentType = GLTFFloat, bool bNormalized = false)
+        {
+            Json->WriteObjectStart();
+            Json->WriteValue(TEXT("bufferView"), BufferView);
+            Json->WriteValue(TEXT("componentType"), ComponentType);
+            if (bNormalized)
+            {
+                Json->WriteValue(TEXT("normalized"), true);
+            }
+            Json->WriteValue(TEXT("count"), Data.NumWedges());
+            Json->WriteValue(TEXT("type"), Type);
+        };
+
+        // Quantized bounds are rounded the same way as the positions, which keeps them exact
+        if (bQuantize)
+        {
+            const FIntVector Min = QuantizePosition(Layout, Layout.Bounds.Min);
+            const FIntVector Max = QuantizePosition(Layout, Layout.Bounds.Max);
+            WriteVertexAccessor(Layout.PositionView, TEXT("VEC3"), GLTFShort);
+            Json->WriteArrayStart(TEXT("min"));
+            Json->WriteValue(Min.X);
+            Json->WriteValue(Min.Y);
+            Json->WriteValue(Min.Z);
+            Json->WriteArrayEnd();
+            Json->WriteArrayStart(TEXT("max"));
+            Json->WriteValue(Max.X);
+            Json->WriteValue(Max.Y);
+            Json->WriteValue(Max.Z);
+            Json->WriteArrayEnd();
+        }
+        else
+        {
+            WriteVertexAccessor(Layout.PositionView, TEXT("VEC3"));
+            Json->WriteArrayStart(TEXT("min"));
+            Json->WriteValue(Layout.Bounds.Min.X);
+            Json->WriteValue(Layout.Bounds.Min.Y);
+            Json->WriteValue(Layout.Bounds.Min.Z);
+            Json->WriteArrayEnd();
+            Json->WriteArrayStart(TEXT("max"));
+            Json->WriteValue(Layout.Bounds.Max.X);
+            Json->WriteValue(Layout.Bounds.Max.Y);
+            Json->WriteValue(Layout.Bounds.Max.Z);
+            Json->WriteArrayEnd();
+        }
+        Json->WriteObjectEnd();
+
+        if (bQuantize)
+        {
+            WriteVertexAccessor(Layout.NormalView, TEXT("VEC3"), bByteNormals ? GLTFByte : GLTFShort, true);
+        }
+        else
+        {
+            WriteVertexAccessor(Layout.NormalView, TEXT("VEC3"));
+        }
+        Json->WriteObjectEnd();
+
+        if (Layout.bQuantizedUVs)
+        {
+            WriteVertexAccessor(Layout.UVView, TEXT("VEC2"), GLTFUnsignedShort, true);
+        }
+        else
+        {
+            WriteVertexAccessor(Layout.UVView, TEXT("VEC2"));
+        }
+        Json->WriteObjectEnd();
+
+        for (int32 SectionIndex = 0; SectionIndex < Data.Sections.Num(); SectionIndex++)
+        {
+            if (Layout.SectionViews[SectionIndex] == INDEX_NONE)
+            {
+                continue;
+            }
+            Json->WriteObjectStart();
+            Json->WriteValue(TEXT("bufferView"), Layout.SectionViews[SectionIndex]);
+            Json->WriteValue(TEXT("componentType"), Layout.bShortIndices ? GLTFUnsignedShort : GLTFUnsignedInt);
+            Json->WriteValue(TEXT("count"), Data.Sections[SectionIndex].Indices.Num() / 3 * 3);
+            Json->WriteValue(TEXT("type"), TEXT("SCALAR"));
+            Json->WriteObjectEnd();
+        }
+    }
+    Json->WriteArrayEnd();
+
+    Json->WriteArrayStart(TEXT("bufferViews"));
+    for (const FGLBBufferView& View : BufferViews)
+    {
+        Json->WriteObjectStart();
+        Json->WriteValue(TEXT("buffer"), 0);
+        Json->WriteValue(TEXT("byteOffset"), View.Offset);
+        Json->WriteValue(TEXT("byteLength"), View.Length);
+        if (View.ByteStride != 0)
+        {
+            Json->WriteValue(TEXT("byteStride"), View.ByteStride);
+        }
+        if (View.Target != 0)
+        {
+            Json->WriteValue(TEXT("target"), View.Target);
+        }
+        Json->WriteObjectEnd();
+    }
+    Json->WriteArrayEnd();
+
+    Json->WriteArrayStart(TEXT("buffers"));
+    Json->WriteObjectStart();
+    Json->WriteValue(TEXT("byteLength"), BinLength);
+    Json->WriteObjectEnd();
+    Json->WriteArrayEnd();
+
+    Json->WriteObjectEnd();
+    Json->Close();
+
+    // Chunks are padded to 4 bytes, JSON with spaces and BIN with zeros
+    FTCHARToUTF8 JsonUTF8(*JsonText);
+    const int64 JsonLength = AlignTo4(JsonUTF8.Length());
+    const int64 TotalLength = 12 + 8 + JsonLength + 8 + BinLength;
+    if (TotalLength > MAX_uint32)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Scene is too large for a GLB file (%lld bytes): %s"), TotalLength, *FilePath);
+        return false;
+    }
+
+    FMeshExportFileWriter Writer;
+    if (!Writer.Open(FilePath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to save GLB file: %s"), *FilePath);
+        return false;
+    }
+
+    if (Progress)
+    {
+        Writer.SetProgress(Progress, TotalWedges * 3 + TotalTriangles);
+    }
+
+    const uint8 Padding[4] = { 0, 0, 0, 0 };
+    const ANSICHAR Spaces[4] = { ' ', ' ', ' ', ' ' };
+
+    const uint32 Header[5] = { GLBMagic, GLBVersion, static_cast<uint32>(TotalLength), static_cast<uint32>(JsonLength), GLBChunkJSON };
+    Writer.Write(Header, sizeof(Header));
+    Writer.Write(reinterpret_cast<const void*>(JsonUTF8.Get()), JsonUTF8.Length());
+    Writer.Write(Spaces, static_cast<int32>(JsonLength - JsonUTF8.Length()));
+
+    const uint32 BinHeader[2] = { static_cast<uint32>(BinLength), GLBChunkBIN };
+    Writer.Write(BinHeader, sizeof(BinHeader));
+
+    // Pads the view just written up to the start of the next one
+    int64 BinWritten = 0;
+    auto EndBufferView = [&Writer, &Padding, &BinWritten](const FGLBBufferView& View)
+    {
+        BinWritten = AlignTo4(View.Offset + View.Length);
+        Writer.Write(Padding, BinWritten - View.Offset - View.Length);
+    };
+
+    const bool bParallel = Settings.bParallelSerialization;
+
+    for (const int32 MeshIndex : WrittenMeshes)
+    {
+        const FMeshExportMeshData& Data = Meshes[MeshIndex];
+        const FGLBMeshLayout& Layout = Layouts[MeshIndex];
+        const int32 NumWedges = Data.NumWedges();
+
+        {
+            MESH_EXPORT_STAGE_SCOPE(Report, TEXT("GLB vertex streams"), &Writer);
+            Writer.WriteChunked(NumWedges, [&](FMeshExportTextBuffer& Bytes, int32 Begin, int32 End)
+            {
+                for (int32 Wedge = Begin; Wedge < End; ++Wedge)
+                {
+                    const FVector3f Position = ToGLTFPosition(Data.Positions[Data.WedgePositions[Wedge]]);
+                    if (bQuantize)
+                    {
+                        const FIntVector Quantized = QuantizePosition(Layout, Position);
+                        const int16 Values[4] = { static_cast<int16>(Quantized.X), static_cast<int16>(Quantized.Y), static_cast<int16>(Quantized.Z), 0 };
+                        Bytes.AppendBinary(Values, sizeof(Values));
+                    }
+                    else
+                    {
+                        Bytes.AppendBinary(&Position, sizeof(Position));
+                    }
+                }
+            }, bParallel);
+            EndBufferView(BufferViews[Layout.PositionView]);
+
+            Writer.WriteChunked(NumWedges, [&](FMeshExportTextBuffer& Bytes, int32 Begin, int32 End)
+            {
+                for (int32 Wedge = Begin; Wedge < End; ++Wedge)
+                {
+                    const FVector3f Normal = ToGLTFNormal(Data.WedgeNormals[Wedge]);
+                    if (bQuantize && bByteNormals)
+                    {
+                        const int8 Values[4] = { static_cast<int8>(QuantizeNormalized(Normal.X, NormalGridMax, MAX_int8)),
+                            static_cast<int8>(QuantizeNormalized(Normal.Y, NormalGridMax, MAX_int8)), static_cast<int8>(QuantizeNormalized(Normal.Z, NormalGridMax, MAX_int8)), 0 };
+                        Bytes.AppendBinary(Values, sizeof(Values));
+                    }
+                    else if (bQuantize)
+                    {
+                        const int16 Values[4] = { static_cast<int16>(QuantizeNormalized(Normal.X, NormalGridMax, MAX_int16)),
+                            static_cast<int16>(QuantizeNormalized(Normal.Y, NormalGridMax, MAX_int16)), static_cast<int16>(QuantizeNormalized(Normal.Z, NormalGridMax, MAX_int16)), 0 };
+                        Bytes.AppendBinary(Values, sizeof(Values));
+                    }
+                    else
+                    {
+                        Bytes.AppendBinary(&Normal, sizeof(Normal));
+                    }
+                }
+            }, bParallel);
+            EndBufferView(BufferViews[Layout.NormalView]);
+
+            // glTF and Unreal both put the UV origin at the top left, so UVs are written as is
+            Writer.WriteChunked(NumWedges, [&](FMeshExportTextBuffer& Bytes, int32 Begin, int32 End)
+            {
+                if (Layout.bQuantizedUVs)
+                {
+                    for (int32 Wedge = Begin; Wedge < End; ++Wedge)
+                    {
+                        const FVector2f& UV = Data.WedgeUVs[Wedge];
+                        const uint16 Values[2] = { static_cast<uint16>(QuantizeNormalized(UV.X, UVGridMax, MAX_uint16)),
+                            static_cast<uint16>(QuantizeNormalized(UV.Y, UVGridMax, MAX_uint16)) };
+                        Bytes.AppendBinary(Values, sizeof(Values));
+                    }
+                }
+                else
+                {
+                    Bytes.AppendBinary(&Data.WedgeUVs[Begin], (End - Begin) * sizeof(FVector2f));
+                }
+            }, bParallel);
+            EndBufferView(BufferViews[Layout.UVView]);
+        }
+
+        {
+            MESH_EXPORT_STAGE_SCOPE(Report, TEXT("GLB indices"), &Writer);
+            for (int32 SectionIndex = 0; SectionIndex < Data.Sections.Num(); SectionIndex++)
+            {
+                if (Layout.SectionViews[SectionIndex] == INDEX_NONE)
+                {
+                    continue;
+                }
+
+                const TArray<int32>& Indices = Data.Sections[SectionIndex].Indices;
+                Writer.WriteChunked(Indices.Num() / 3, [&](FMeshExportTextBuffer& Bytes, int32 Begin, int32 End)
+                {
+                    if (Layout.bShortIndices)
+                    {
+                        for (int32 Index = Begin * 3; Index < End * 3; ++Index)
+                        {
+                            const uint16 Value = static_cast<uint16>(Indices[Index]);
+                            Bytes.AppendBinary(&Value, sizeof(Value));
+                        }
+                    }
+                    else
+                    {
+                        Bytes.AppendBinary(&Indices[Begin * 3], (End - Begin) * 3 * sizeof(int32));
+                    }
+                }, bParallel);
+                EndBufferView(BufferViews[Layout.SectionViews[SectionIndex]]);
+            }
+        }
+
+        if (Writer.WasCancelled())
+        {
+            break;
+        }
+    }
+
+    for (const FGLBImage& Image : Images)
+    {
+        if (Image.BufferView != INDEX_NONE && !Writer.WasCancelled())
+        {
+            MESH_EXPORT_STAGE_SCOPE(Report, TEXT("GLB images"), &Writer);
+            Writer.Write(Image.Bytes.GetData(), Image.Bytes.Num());
+            EndBufferView(BufferViews[Image.BufferView]);
+        }
+    }
+
+    // Flush the remaining data and close the file
+    const bool bCancelled = Writer.WasCancelled();
+    check(bCancelled || BinWritten == BinLength);
+    WriteTimer.AddBytes(Writer.GetBytesWritten());
+    bool bSuccess = Writer.Close() && !bCancelled;
+
+    if (Report && bSuccess)
+    {
+        Report->VerticesWritten += TotalWedges;
+        Report->TrianglesWritten += TotalTriangles;
+    }
+
+    if (bCancelled)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("GLB export cancelled, discarded partial file: %s"), *FilePath);
+    }
+    else if (!bSuccess)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to save GLB file: %s"), *FilePath);
+    }
+
+    return bSuccess;
+}
+
+bool FMeshExportGLBWriter::Write(const FMeshExportMeshData& Data, TConstArrayView<FMeshExportGLBMaterial> Materials, const FString& FilePath,
+    const FMeshExportSettings& Settings, FMeshExportProgress* Progress, FMeshExportReport* Report)
+{
+    FMeshExportInstance Instance;
+    Instance.Name = Data.Name;
+    Instance.MeshIndex = 0;
+    return WriteGLB(MakeArrayView(&Data, 1), MakeArrayView(&Instance, 1), Materials, FilePath, Settings, Progress, Report);
+}
+
+bool FMeshExportGLBWriter::WriteScene(const FMeshExportScene& Scene, TConstArrayView<FMeshExportGLBMaterial> Materials, const FString& FilePath,
+    const FMeshExportSettings& Settings, FMeshExportProgress* Progress, FMeshExportReport* Report)
+{
+    return WriteGLB(Scene.Meshes, Scene.Instances, Materials, FilePath, Settings, Progress, Report);
+}
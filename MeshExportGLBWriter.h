@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MeshExportMaterials.h"
+
+struct FMeshExportMeshData;
+struct FMeshExportScene;
+struct FMeshExportSettings;
+class FMeshExportProgress;
+struct FMeshExportReport;
+
+/** Material of a GLB export; sections use the material with their MaterialName. */
+struct FMeshExportGLBMaterial
+{
+	FString Name;
+
+	/** Full path of the image of each EMeshExportMaterialChannel, empty if there is none. glTF only allows PNG and JPEG images. */
+	FString TexturePaths[MeshExportNumMaterialChannels];
+
+	/** Paths of the same images relative to the GLB file, used when textures are referenced instead of embedded. */
+	FString TextureURIs[MeshExportNumMaterialChannels];
+};
+
+/**
+ * Writes FMeshExportMeshData as binary glTF 2.0 (GLB).
+ * Every wedge becomes one glTF vertex with tightly packed POSITION, NORMAL and TEXCOORD_0 buffer views, and every
+ * section one primitive with its own index buffer view. Positions are converted to meters with the same axis swap as the OBJ writer.
+ * With bQuantizeGeometry the vertex streams are written as integers using KHR_mesh_quantization.
+ */
+struct SAFRAN_APP_API FMeshExportGLBWriter
+{
+	/**
+	 * Writes Data to FilePath as a single node. Only touches the data passed in and the image files the materials name,
+	 * so it can run on any thread. Progress and Report work as for FMeshExportOBJWriter::Write.
+	 */
+	static bool Write(const FMeshExportMeshData& Data, TConstArrayView<FMeshExportGLBMaterial> Materials, const FString& FilePath,
+		const FMeshExportSettings& Settings, FMeshExportProgress* Progress = nullptr, FMeshExportReport* Report = nullptr);
+
+	/**
+	 * Writes every mesh of Scene once and every instance as a named node referencing it with its transform,
+	 * so the file size follows the unique geometry rather than the number of instances. Same rules as Write.
+	 */
+	static bool WriteScene(const FMeshExportScene& Scene, TConstArrayView<FMeshExportGLBMaterial> Materials, const FString& FilePath,
+		const FMeshExportSettings& Settings, FMeshExportProgress* Progress = nullptr, FMeshExportReport* Report = nullptr);
+};
@@ -0,0 +1,128 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MeshExportIndexOptimizer.h"
+
+namespace MeshExportIndices
+{
+    void OptimizeVertexCache(TArrayView<int32> Indices, int32 NumVertices, int32 CacheSize)
+    {
+        const int32 NumTriangles = Indices.Num() / 3;
+        if (NumTriangles < 2)
+        {
+            return;
+        }
+
+        // Triangles around each vertex, as offsets into one shared list
+        TArray<int32> AdjacencyOffsets;
+        AdjacencyOffsets.SetNumZeroed(NumVertices + 1);
+        for (int32 Index = 0; Index < NumTriangles * 3; ++Index)
+        {
+            AdjacencyOffsets[Indices[Index] + 1]++;
+        }
+        for (int32 Vertex = 0; Vertex < NumVertices; ++Vertex)
+        {
+            AdjacencyOffsets[Vertex + 1] += AdjacencyOffsets[Vertex];
+        }
+
+        TArray<int32> Adjacency;
+        Adjacency.SetNumUninitialized(NumTriangles * 3);
+        TArray<int32> LiveTriangles;
+        LiveTriangles.SetNumZeroed(NumVertices);
+        for (int32 Index = 0; Index < NumTriangles * 3; ++Index)
+        {
+            const int32 Vertex = Indices[Index];
+            Adjacency[AdjacencyOffsets[Vertex] + LiveTriangles[Vertex]++] = Index / 3;
+        }
+
+        // Time each vertex last entered the simulated FIFO cache
+        TArray<int32> CacheTime;
+        CacheTime.SetNumZeroed(NumVertices);
+        int32 Time = CacheSize + 1;
+
+        TArray<bool> Emitted;
+        Emitted.SetNumZeroed(NumTriangles);
+        // Every emitted corner is pushed once, so the stack never outgrows the index count
+        TArray<int32> DeadEnds;
+        DeadEnds.SetNumUninitialized(NumTriangles * 3);
+        int32 NumDeadEnds = 0;
+        TArray<int32> Candidates;
+
+        TArray<int32> Output;
+        Output.Reserve(NumTriangles * 3);
+
+        int32 Cursor = 0;
+        auto SkipDeadEnd = [&]() -> int32
+        {
+            // Most recently used vertices with triangles left first, then the next one in input order
+            while (NumDeadEnds > 0)
+            {
+                const int32 Vertex = DeadEnds[--NumDeadEnds];
+                if (LiveTriangles[Vertex] > 0)
+                {
+                    return Vertex;
+                }
+            }
+            for (; Cursor < NumVertices; ++Cursor)
+            {
+                if (LiveTriangles[Cursor] > 0)
+                {
+                    return Cursor;
+                }
+            }
+            return INDEX_NONE;
+        };
+
+        int32 Fan = SkipDeadEnd();
+        while (Fan != INDEX_NONE)
+        {
+            // Emit every remaining triangle around the fanning vertex
+            Candidates.Reset();
+            for (int32 Entry = AdjacencyOffsets[Fan]; Entry < AdjacencyOffsets[Fan + 1]; ++Entry)
+            {
+                const int32 Triangle = Adjacency[Entry];
+                if (Emitted[Triangle])
+                {
+                    continue;
+                }
+                Emitted[Triangle] = true;
+
+                for (int32 Corner = 0; Corner < 3; ++Corner)
+                {
+                    const int32 Vertex = Indices[Triangle * 3 + Corner];
+                    Output.Add(Vertex);
+                    DeadEnds[NumDeadEnds++] = Vertex;
+                    Candidates.Add(Vertex);
+                    LiveTriangles[Vertex]--;
+                    if (Time - CacheTime[Vertex] > CacheSize)
+                    {
+                        CacheTime[Vertex] = Time++;
+                    }
+                }
+            }
+
+            // Next fan: the candidate still in the cache that stays there longest once its triangles are emitted
+            int32 Best = INDEX_NONE;
+            int32 BestPriority = -1;
+            for (int32 Vertex : Candidates)
+            {
+                if (LiveTriangles[Vertex] > 0)
+                {
+                    int32 Priority = 0;
+                    if (Time - CacheTime[Vertex] + 2 * LiveTriangles[Vertex] <= CacheSize)
+                    {
+                        Priority = Time - CacheTime[Vertex];
+                    }
+                    if (Priority > BestPriority)
+                    {
+                        BestPriority = Priority;
+                        Best = Vertex;
+                    }
+                }
+            }
+            Fan = Best != INDEX_NONE ? Best : SkipDeadEnd();
+        }
+
+        check(Output.Num() == NumTriangles * 3);
+        FMemory::Memcpy(Indices.GetData(), Output.GetData(), Output.Num() * sizeof(int32));
+    }
+}
@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Triangle and vertex reordering for GPU friendly index streams. Only the order changes: every triangle keeps its
+ * corners and their winding, so the exported mesh looks exactly the same.
+ */
+namespace MeshExportIndices
+{
+	/** Post-transform cache size the triangle order is tuned for; small enough to suit most GPUs. */
+	constexpr int32 DefaultCacheSize = 16;
+
+	/**
+	 * Reorders the triangles of Indices (three per triangle, each below NumVertices) for vertex cache locality,
+	 * using Tipsify (Sander, Nehab and Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw").
+	 * Runs in linear time.
+	 */
+	SAFRAN_APP_API void OptimizeVertexCache(TArrayView<int32> Indices, int32 NumVertices, int32 CacheSize = DefaultCacheSize);
+}
@@ -0,0 +1,228 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MeshExportMaterials.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialInterface.h"
+#include "Materials/MaterialInstance.h"
+#include "Engine/Texture2D.h"
+
+const TCHAR* LexToString(EMeshExportMaterialChannel Channel)
+{
+    switch (Channel)
+    {
+    case EMeshExportMaterialChannel::BaseColor: return TEXT("base color");
+    case EMeshExportMaterialChannel::Normal: return TEXT("normal");
+    case EMeshExportMaterialChannel::Roughness: return TEXT("roughness");
+    case EMeshExportMaterialChannel::Metallic: return TEXT("metallic");
+    case EMeshExportMaterialChannel::Occlusion: return TEXT("occlusion");
+    case EMeshExportMaterialChannel::Emissive: return TEXT("emissive");
+    default: return TEXT("unknown");
+    }
+}
+
+static constexpr uint32 ChannelBit(EMeshExportMaterialChannel Channel)
+{
+    return 1u << static_cast<uint32>(Channel);
+}
+
+/**
+ * Channels a parameter or texture name stands for, as a mask of ChannelBit. Long keywords match anywhere in the name,
+ * short ones such as the _N and _ORM suffixes only as a whole "_" separated part. Normal and emissive are checked
+ * before base color since names like EmissiveColor also mention color.
+ */
+static uint32 ClassifyName(const FString& Name)
+{
+    const FString Lower = Name.ToLower();
+    TArray<FString> Parts;
+    Lower.ParseIntoArray(Parts, TEXT("_"));
+
+    auto Matches = [&Lower, &Parts](std::initializer_list<const TCHAR*> Keywords, std::initializer_list<const TCHAR*> PartKeywords)
+    {
+        for (const TCHAR* Keyword : Keywords)
+        {
+            if (Lower.Contains(Keyword))
+            {
+                return true;
+            }
+        }
+        for (const TCHAR* Keyword : PartKeywords)
+        {
+            if (Parts.Contains(Keyword))
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    if (Matches({ TEXT("normal"), TEXT("nrm") }, { TEXT("n") }))
+    {
+        return ChannelBit(EMeshExportMaterialChannel::Normal);
+    }
+    if (Matches({ TEXT("emissive"), TEXT("emission"), TEXT("glow") }, { TEXT("e") }))
+    {
+        return ChannelBit(EMeshExportMaterialChannel::Emissive);
+    }
+    if (Matches({ TEXT("occlusionroughnessmetal") }, { TEXT("orm"), TEXT("arm"), TEXT("rma") }))
+    {
+        return ChannelBit(EMeshExportMaterialChannel::Occlusion) | ChannelBit(EMeshExportMaterialChannel::Roughness)
+            | ChannelBit(EMeshExportMaterialChannel::Metallic);
+    }
+    if (Matches({ TEXT("rough") }, { TEXT("r") }))
+    {
+        return ChannelBit(EMeshExportMaterialChannel::Roughness);
+    }
+    if (Matches({ TEXT("metal") }, { TEXT("m") }))
+    {
+        return ChannelBit(EMeshExportMaterialChannel::Metallic);
+    }
+    if (Matches({ TEXT("occlusion") }, { TEXT("ao") }))
+    {
+        return ChannelBit(EMeshExportMaterialChannel::Occlusion);
+    }
+    if (Matches({ TEXT("basecolor"), TEXT("diffuse"), TEXT("albedo"), TEXT("color"), TEXT("colour") }, { TEXT("d"), TEXT("bc"), TEXT("texture") }))
+    {
+        return ChannelBit(EMeshExportMaterialChannel::BaseColor);
+    }
+    return 0;
+}
+
+/** ClassifyName for a texture, using its compression settings when the name says nothing. */
+static uint32 ClassifyTexture(const UTexture2D* Texture)
+{
+    if (const uint32 Channels = ClassifyName(Texture->GetName()))
+    {
+        return Channels;
+    }
+
+    switch (Texture->CompressionSettings)
+    {
+    case TC_Normalmap:
+        return ChannelBit(EMeshExportMaterialChannel::Normal);
+    case TC_Masks:
+        return ChannelBit(EMeshExportMaterialChannel::Occlusion) | ChannelBit(EMeshExportMaterialChannel::Roughness)
+            | ChannelBit(EMeshExportMaterialChannel::Metallic);
+    default:
+        // Color data is the most likely base color
+        return Texture->SRGB ? ChannelBit(EMeshExportMaterialChannel::BaseColor) : 0;
+    }
+}
+
+const FMeshExportMaterialTextures& FMeshExportMaterialResolver::Resolve(UMaterialInterface* Material)
+{
+    check(IsInGameThread());
+
+    if (const FMeshExportMaterialTextures* Resolved = ResolvedMaterials.Find(Material))
+    {
+        return *Resolved;
+    }
+
+    FMeshExportMaterialTextures Textures;
+    uint32 MissingChannels = (1u << MeshExportNumMaterialChannels) - 1;
+
+    // Parameters first: the mapping comes from the parent, the values from the material itself
+    if (UMaterial* BaseMaterial = Material->GetMaterial())
+    {
+        const FParameterMapping& Mapping = GetParameterMapping(BaseMaterial);
+        for (int32 Channel = 0; Channel < MeshExportNumMaterialChannels; Channel++)
+        {
+            UTexture* Texture = nullptr;
+            if (!Mapping.Parameters[Channel].Name.IsNone()
+                && Material->GetTextureParameterValue(FHashedMaterialParameterInfo(Mapping.Parameters[Channel]), Texture))
+            {
+                Textures.Textures[Channel] = Cast<UTexture2D>(Texture);
+            }
+            if (Textures.Textures[Channel])
+            {
+                MissingChannels &= ~(1u << Channel);
+            }
+        }
+    }
+
+    // Overrides set on an instance under a name the parent does not expose are not in the mapping, look them up by name,
+    // closest instance first
+    for (UMaterialInstance* Instance = Cast<UMaterialInstance>(Material); Instance && MissingChannels != 0; Instance = Cast<UMaterialInstance>(Instance->Parent))
+    {
+        for (const FTextureParameterValue& Value : Instance->TextureParameterValues)
+        {
+            UTexture2D* Texture = Cast<UTexture2D>(Value.ParameterValue);
+            const uint32 Channels = Texture ? ClassifyName(Value.ParameterInfo.Name.ToString()) & MissingChannels : 0;
+            for (int32 Channel = 0; Channel < MeshExportNumMaterialChannels; Channel++)
+            {
+                if (Channels & (1u << Channel))
+                {
+                    Textures.Textures[Channel] = Texture;
+                }
+            }
+            MissingChannels &= ~Channels;
+        }
+    }
+
+    // Textures sampled directly by the material graph are not parameters, match them by name instead
+    if (MissingChannels != 0)
+    {
+        TArray<UTexture*> UsedTextures;
+        Material->GetUsedTextures(UsedTextures, EMaterialQualityLevel::Num, true, ERHIFeatureLevel::SM5, true);
+        for (UTexture* UsedTexture : UsedTextures)
+        {
+            UTexture2D* Texture = Cast<UTexture2D>(UsedTexture);
+            const uint32 Channels = Texture ? ClassifyTexture(Texture) & MissingChannels : 0;
+            for (int32 Channel = 0; Channel < MeshExportNumMaterialChannels; Channel++)
+            {
+                if (Channels & (1u << Channel))
+                {
+                    Textures.Textures[Channel] = Texture;
+                }
+            }
+            MissingChannels &= ~Channels;
+        }
+    }
+
+    FString Found;
+    for (int32 Channel = 0; Channel < MeshExportNumMaterialChannels; Channel++)
+    {
+        if (Textures.Textures[Channel])
+        {
+            Found += FString::Printf(TEXT(" %s=%s"), LexToString(static_cast<EMeshExportMaterialChannel>(Channel)), *Textures.Textures[Channel]->GetName());
+        }
+    }
+    UE_LOG(LogTemp, Log, TEXT("Material %s textures:%s"), *Material->GetName(), Found.IsEmpty() ? TEXT(" none") : *Found);
+
+    return ResolvedMaterials.Add(Material, Textures);
+}
+
+void FMeshExportMaterialResolver::Reset()
+{
+    ParameterMappings.Reset();
+    ResolvedMaterials.Reset();
+}
+
+const FMeshExportMaterialResolver::FParameterMapping& FMeshExportMaterialResolver::GetParameterMapping(UMaterial* BaseMaterial)
+{
+    if (const FParameterMapping* Mapping = ParameterMappings.Find(BaseMaterial))
+    {
+        return *Mapping;
+    }
+
+    TArray<FMaterialParameterInfo> ParameterInfos;
+    TArray<FGuid> ParameterIds;
+    BaseMaterial->GetAllTextureParameterInfo(ParameterInfos, ParameterIds);
+
+    // The first parameter matching a channel feeds it
+    FParameterMapping Mapping;
+    uint32 MappedChannels = 0;
+    for (const FMaterialParameterInfo& ParameterInfo : ParameterInfos)
+    {
+        const uint32 Channels = ClassifyName(ParameterInfo.Name.ToString()) & ~MappedChannels;
+        for (int32 Channel = 0; Channel < MeshExportNumMaterialChannels; Channel++)
+        {
+            if (Channels & (1u << Channel))
+            {
+                Mapping.Parameters[Channel] = ParameterInfo;
+            }
+        }
+        MappedChannels |= Channels;
+    }
+
+    return ParameterMappings.Add(BaseMaterial, Mapping);
+}
@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MaterialTypes.h"
+#include "UObject/ObjectKey.h"
+
+class UMaterial;
+class UMaterialInterface;
+class UTexture2D;
+
+/** Texture slots of an exported material. Roughness, metallic and occlusion may all be the same packed texture. */
+enum class EMeshExportMaterialChannel : uint8
+{
+	BaseColor,
+	Normal,
+	Roughness,
+	Metallic,
+	Occlusion,
+	Emissive,
+	Num
+};
+
+constexpr int32 MeshExportNumMaterialChannels = static_cast<int32>(EMeshExportMaterialChannel::Num);
+
+SAFRAN_APP_API const TCHAR* LexToString(EMeshExportMaterialChannel Channel);
+
+/** Textures feeding each channel of one material, null for channels without one. */
+struct FMeshExportMaterialTextures
+{
+	UTexture2D* Textures[MeshExportNumMaterialChannels] = {};
+
+	UTexture2D* Get(EMeshExportMaterialChannel Channel) const { return Textures[static_cast<int32>(Channel)]; }
+};
+
+/**
+ * Finds the textures behind the channels of materials. Which texture parameter feeds which channel is worked out from
+ * the parameter names once per parent material, and each material's textures are looked up once, so exports with
+ * thousands of instances of a few parents do not repeat the searches. Channels no parameter could be matched to fall
+ * back to the textures the material uses, matched by name and compression settings. Game thread only.
+ */
+class SAFRAN_APP_API FMeshExportMaterialResolver
+{
+public:
+	/** Textures of Material, resolved on the first call and cached after that. Valid until the next call. */
+	const FMeshExportMaterialTextures& Resolve(UMaterialInterface* Material);
+
+	/** Forgets every material; call between exports since materials may have been edited. */
+	void Reset();
+
+private:
+	/** Texture parameter feeding each channel, with an empty name for channels no parameter matched. */
+	struct FParameterMapping
+	{
+		FMaterialParameterInfo Parameters[MeshExportNumMaterialChannels];
+	};
+
+	const FParameterMapping& GetParameterMapping(UMaterial* BaseMaterial);
+
+	/** Object keys rather than pointers, so a material created where a garbage collected one was is not mistaken for it. */
+	TMap<TObjectKey<UMaterial>, FParameterMapping> ParameterMappings;
+	TMap<TObjectKey<UMaterialInterface>, FMeshExportMaterialTextures> ResolvedMaterials;
+};
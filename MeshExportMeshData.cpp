@@ -0,0 +1,301 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MeshExportMeshData.h"
+#include "MeshDescription.h"
+#include "StaticMeshAttributes.h"
+#include "StaticMeshResources.h"
+#include "MeshExportIndexOptimizer.h"
+
+int32 FMeshExportMeshData::NumTriangles() const
+{
+    int32 NumTriangles = 0;
+    for (const FMeshExportSection& Section : Sections)
+    {
+        NumTriangles += Section.Indices.Num() / 3;
+    }
+    return NumTriangles;
+}
+
+void FMeshExportMeshData::Reset()
+{
+    Name.Reset();
+    Positions.Reset();
+    WedgePositions.Reset();
+    WedgeNormals.Reset();
+    WedgeUVs.Reset();
+    Sections.Reset();
+}
+
+void FMeshExportInstance::SetTransform(const FMatrix& InTransform)
+{
+    Transform = InTransform;
+    bIsIdentity = InTransform.Equals(FMatrix::Identity, 0.0);
+
+    // Normals go through the inverse transpose so non-uniform scale keeps them perpendicular to the surface
+    NormalTransform = bIsIdentity ? FMatrix::Identity : InTransform.Inverse().GetTransposed();
+    bFlipsWinding = InTransform.Determinant() < 0.0;
+}
+
+int64 FMeshExportScene::NumInstancedTriangles() const
+{
+    int64 NumTriangles = 0;
+    for (const FMeshExportInstance& Instance : Instances)
+    {
+        NumTriangles += Meshes[Instance.MeshIndex].NumTriangles();
+    }
+    return NumTriangles;
+}
+
+void FMeshExportScene::Reset()
+{
+    Meshes.Reset();
+    Instances.Reset();
+}
+
+bool FMeshExportMeshData::BuildFromMeshDescription(const FMeshDescription& MeshDescription, TConstArrayView<FString> SectionMaterialNames)
+{
+    Positions.Reset();
+    WedgePositions.Reset();
+    WedgeNormals.Reset();
+    WedgeUVs.Reset();
+    Sections.Reset();
+
+    FStaticMeshConstAttributes Attributes(MeshDescription);
+    TVertexAttributesConstRef<FVector3f> VertexPositions = Attributes.GetVertexPositions();
+    TVertexInstanceAttributesConstRef<FVector3f> VertexNormals = Attributes.GetVertexInstanceNormals();
+    TVertexInstanceAttributesConstRef<FVector2f> VertexUVs = Attributes.GetVertexInstanceUVs();
+
+    if (!VertexPositions.IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("Mesh description has no vertex positions"));
+        return false;
+    }
+
+    const bool bHasNormals = VertexNormals.IsValid();
+    const bool bHasUVs = VertexUVs.IsValid() && VertexUVs.GetNumChannels() > 0;
+
+    // Element IDs are dense small integers, so the ID -> index remaps are flat arrays indexed by
+    // ID value. Indices are assigned in iteration order, which compacts any gaps left by deleted elements.
+    TArray<int32> VertexToIndex;
+    VertexToIndex.Init(INDEX_NONE, MeshDescription.Vertices().GetArraySize());
+    Positions.Reserve(MeshDescription.Vertices().Num());
+
+    for (const FVertexID VertexID : MeshDescription.Vertices().GetElementIDs())
+    {
+        VertexToIndex[VertexID.GetValue()] = Positions.Add(VertexPositions[VertexID]);
+    }
+
+    TArray<int32> InstanceToWedge;
+    InstanceToWedge.Init(INDEX_NONE, MeshDescription.VertexInstances().GetArraySize());
+
+    const int32 NumInstances = MeshDescription.VertexInstances().Num();
+    WedgePositions.Reserve(NumInstances);
+    WedgeNormals.Reserve(NumInstances);
+    WedgeUVs.Reserve(NumInstances);
+
+    for (const FVertexInstanceID InstanceID : MeshDescription.VertexInstances().GetElementIDs())
+    {
+        InstanceToWedge[InstanceID.GetValue()] = WedgePositions.Add(VertexToIndex[MeshDescription.GetVertexInstanceVertex(InstanceID).GetValue()]);
+        WedgeNormals.Add(bHasNormals ? VertexNormals[InstanceID] : FVector3f::ZeroVector);
+        WedgeUVs.Add(bHasUVs ? VertexUVs.Get(InstanceID, 0) : FVector2f::ZeroVector);
+    }
+
+    for (int32 MatIndex = 0; MatIndex < SectionMaterialNames.Num(); MatIndex++)
+    {
+        if (SectionMaterialNames[MatIndex].IsEmpty())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Material %d is null"), MatIndex);
+            continue;
+        }
+
+        FMeshExportSection& Section = Sections.AddDefaulted_GetRef();
+        Section.MaterialName = SectionMaterialNames[MatIndex];
+        Section.MaterialIndex = MatIndex;
+
+        // Each material index maps to the polygon group (section) with the same index; walk only
+        // that group's polygons so the pass stays linear in the number of polygons
+        const FPolygonGroupID PolygonGroupID(MatIndex);
+        if (!MeshDescription.PolygonGroups().IsValid(PolygonGroupID))
+        {
+            continue;
+        }
+
+        for (const FPolygonID PolygonID : MeshDescription.GetPolygonGroupPolygonIDs(PolygonGroupID))
+        {
+            for (const FTriangleID TriangleID : MeshDescription.GetPolygonTriangles(PolygonID))
+            {
+                TArrayView<const FVertexInstanceID> VertexInstances = MeshDescription.GetTriangleVertexInstances(TriangleID);
+                if (VertexInstances.Num() == 3)
+                {
+                    Section.Indices.Add(InstanceToWedge[VertexInstances[0].GetValue()]);
+                    Section.Indices.Add(InstanceToWedge[VertexInstances[1].GetValue()]);
+                    Section.Indices.Add(InstanceToWedge[VertexInstances[2].GetValue()]);
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+bool FMeshExportMeshData::BuildFromRenderData(const FStaticMeshLODResources& LODResources, TConstArrayView<FString> SectionMaterialNames)
+{
+    Positions.Reset();
+    WedgePositions.Reset();
+    WedgeNormals.Reset();
+    WedgeUVs.Reset();
+    Sections.Reset();
+
+    const FPositionVertexBuffer& PositionBuffer = LODResources.VertexBuffers.PositionVertexBuffer;
+    const FStaticMeshVertexBuffer& VertexBuffer = LODResources.VertexBuffers.StaticMeshVertexBuffer;
+    const FIndexArrayView IndexView = LODResources.IndexBuffer.GetArrayView();
+    const int32 NumVertices = PositionBuffer.GetNumVertices();
+
+    // The CPU copies are released after upload unless the mesh keeps them (editor, or CPU access enabled)
+    if (NumVertices == 0 || !PositionBuffer.GetVertexData() || !VertexBuffer.GetTangentData()
+        || VertexBuffer.GetNumVertices() != static_cast<uint32>(NumVertices) || IndexView.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Render data has no CPU accessible vertex or index data, enable Allow CPU Access on the mesh"));
+        return false;
+    }
+
+    const bool bHasUVs = VertexBuffer.GetNumTexCoords() > 0 && VertexBuffer.GetTexCoordData();
+
+    Positions.Reserve(NumVertices);
+    WedgePositions.SetNumUninitialized(NumVertices);
+    WedgeNormals.SetNumUninitialized(NumVertices);
+    WedgeUVs.SetNumUninitialized(NumVertices);
+
+    // Render vertices are split along normal and UV seams; the copies share one position again, like a mesh description
+    TMap<FVector3f, int32> PositionIndices;
+    PositionIndices.Reserve(NumVertices);
+
+    for (int32 Vertex = 0; Vertex < NumVertices; ++Vertex)
+    {
+        const FVector3f& Position = PositionBuffer.VertexPosition(Vertex);
+        int32* PositionIndex = PositionIndices.Find(Position);
+        WedgePositions[Vertex] = PositionIndex ? *PositionIndex : PositionIndices.Add(Position, Positions.Add(Position));
+        WedgeNormals[Vertex] = FVector3f(VertexBuffer.VertexTangentZ(Vertex));
+        WedgeUVs[Vertex] = bHasUVs ? VertexBuffer.GetVertexUV(Vertex, 0) : FVector2f::ZeroVector;
+    }
+
+    for (int32 MatIndex = 0; MatIndex < SectionMaterialNames.Num(); MatIndex++)
+    {
+        if (SectionMaterialNames[MatIndex].IsEmpty())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Material %d is null"), MatIndex);
+            continue;
+        }
+
+        FMeshExportSection& Section = Sections.AddDefaulted_GetRef();
+        Section.MaterialName = SectionMaterialNames[MatIndex];
+        Section.MaterialIndex = MatIndex;
+
+        // Several render sections can use the same slot; they end up in one export section
+        for (const FStaticMeshSection& RenderSection : LODResources.Sections)
+        {
+            if (RenderSection.MaterialIndex != MatIndex)
+            {
+                continue;
+            }
+
+            const int32 FirstIndex = static_cast<int32>(RenderSection.FirstIndex);
+            const int32 NumIndices = static_cast<int32>(RenderSection.NumTriangles) * 3;
+            if (FirstIndex + NumIndices > IndexView.Num())
+            {
+                UE_LOG(LogTemp, Warning, TEXT("Render section of material %d is out of range of the index buffer"), MatIndex);
+                continue;
+            }
+
+            Section.Indices.Reserve(Section.Indices.Num() + NumIndices);
+            for (int32 Index = FirstIndex; Index < FirstIndex + NumIndices; ++Index)
+            {
+                Section.Indices.Add(static_cast<int32>(IndexView[Index]));
+            }
+        }
+    }
+
+    return true;
+}
+
+void FMeshExportMeshData::OptimizeVertexOrder()
+{
+    const int32 NumSourceWedges = NumWedges();
+
+    // Each section is reordered on its own wedges only, numbered locally so the work follows the section size
+    TArray<int32> GlobalToLocal;
+    GlobalToLocal.Init(INDEX_NONE, NumSourceWedges);
+    TArray<int32> LocalToGlobal;
+    TArray<int32> LocalIndices;
+    for (FMeshExportSection& Section : Sections)
+    {
+        LocalToGlobal.Reset();
+        LocalIndices.SetNumUninitialized(Section.Indices.Num());
+        for (int32 Index = 0; Index < Section.Indices.Num(); ++Index)
+        {
+            int32& Local = GlobalToLocal[Section.Indices[Index]];
+            if (Local == INDEX_NONE)
+            {
+                Local = LocalToGlobal.Add(Section.Indices[Index]);
+            }
+            LocalIndices[Index] = Local;
+        }
+
+        MeshExportIndices::OptimizeVertexCache(LocalIndices, LocalToGlobal.Num());
+
+        for (int32 Index = 0; Index < Section.Indices.Num(); ++Index)
+        {
+            Section.Indices[Index] = LocalToGlobal[LocalIndices[Index]];
+        }
+        for (int32 Global : LocalToGlobal)
+        {
+            GlobalToLocal[Global] = INDEX_NONE;
+        }
+    }
+
+    // Wedges in order of first use by the triangles, positions in order of first use by the wedges
+    TArray<int32> WedgeRemap;
+    WedgeRemap.Init(INDEX_NONE, NumSourceWedges);
+    TArray<int32> NewToOldWedge;
+    NewToOldWedge.Reserve(NumSourceWedges);
+    for (FMeshExportSection& Section : Sections)
+    {
+        for (int32& Wedge : Section.Indices)
+        {
+            int32& NewWedge = WedgeRemap[Wedge];
+            if (NewWedge == INDEX_NONE)
+            {
+                NewWedge = NewToOldWedge.Add(Wedge);
+            }
+            Wedge = NewWedge;
+        }
+    }
+
+    TArray<int32> PositionRemap;
+    PositionRemap.Init(INDEX_NONE, Positions.Num());
+    TArray<FVector3f> NewPositions;
+    NewPositions.Reserve(Positions.Num());
+    TArray<int32> NewWedgePositions;
+    TArray<FVector3f> NewWedgeNormals;
+    TArray<FVector2f> NewWedgeUVs;
+    NewWedgePositions.SetNumUninitialized(NewToOldWedge.Num());
+    NewWedgeNormals.SetNumUninitialized(NewToOldWedge.Num());
+    NewWedgeUVs.SetNumUninitialized(NewToOldWedge.Num());
+    for (int32 NewWedge = 0; NewWedge < NewToOldWedge.Num(); ++NewWedge)
+    {
+        const int32 OldWedge = NewToOldWedge[NewWedge];
+        int32& NewPosition = PositionRemap[WedgePositions[OldWedge]];
+        if (NewPosition == INDEX_NONE)
+        {
+            NewPosition = NewPositions.Add(Positions[WedgePositions[OldWedge]]);
+        }
+        NewWedgePositions[NewWedge] = NewPosition;
+        NewWedgeNormals[NewWedge] = WedgeNormals[OldWedge];
+        NewWedgeUVs[NewWedge] = WedgeUVs[OldWedge];
+    }
+
+    Positions = MoveTemp(NewPositions);
+    WedgePositions = MoveTemp(NewWedgePositions);
+    WedgeNormals = MoveTemp(NewWedgeNormals);
+    WedgeUVs = MoveTemp(NewWedgeUVs);
+}
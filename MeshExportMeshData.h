@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FMeshDescription;
+struct FStaticMeshLODResources;
+
+/** Triangles of one material slot, as indices into the wedge arrays of FMeshExportMeshData. */
+struct FMeshExportSection
+{
+	/** Sanitized material name used for usemtl / material references. */
+	FString MaterialName;
+
+	/** Index of the material slot on the source mesh. */
+	int32 MaterialIndex = INDEX_NONE;
+
+	/** Three wedge indices per triangle. */
+	TArray<int32> Indices;
+};
+
+/**
+ * Plain copy of the geometry that gets exported, detached from any UObject.
+ * Built on the game thread, after which the file writers can work on it from any thread.
+ *
+ * Positions are stored once per vertex; a wedge is a triangle corner (vertex instance) that selects a
+ * position and carries its own normal and UV. Everything is kept in Unreal's coordinate space.
+ */
+struct SAFRAN_APP_API FMeshExportMeshData
+{
+	FString Name;
+
+	TArray<FVector3f> Positions;
+
+	TArray<int32> WedgePositions;
+	TArray<FVector3f> WedgeNormals;
+	TArray<FVector2f> WedgeUVs;
+
+	TArray<FMeshExportSection> Sections;
+
+	int32 NumWedges() const { return WedgePositions.Num(); }
+	int32 NumTriangles() const;
+
+	void Reset();
+
+	/**
+	 * Copies the mesh description. SectionMaterialNames holds one sanitized name per material slot;
+	 * slots with an empty name are skipped, the others take the polygon group with the same index.
+	 */
+	bool BuildFromMeshDescription(const FMeshDescription& MeshDescription, TConstArrayView<FString> SectionMaterialNames);
+
+	/**
+	 * Copies one LOD of render data. Each render vertex becomes a wedge, and render vertices at exactly the same
+	 * position share one position.
+	 * Sections are grouped per material slot the same way as BuildFromMeshDescription. Fails if the CPU copy of the
+	 * buffers is not available, which happens in cooked builds for meshes without CPU access.
+	 */
+	bool BuildFromRenderData(const FStaticMeshLODResources& LODResources, TConstArrayView<FString> SectionMaterialNames);
+
+	/**
+	 * Reorders the triangles of every section for vertex cache locality, then renumbers wedges and positions in the
+	 * order the triangles first use them so vertex fetches run mostly forward. Unused wedges and positions are dropped.
+	 */
+	void OptimizeVertexOrder();
+};
+
+/** One placement of a mesh of an FMeshExportScene. */
+struct FMeshExportInstance
+{
+	/** Sanitized name, written as the OBJ object / glTF node name. */
+	FString Name;
+
+	/** Index into FMeshExportScene::Meshes. */
+	int32 MeshIndex = INDEX_NONE;
+
+	/** Local to world transform, in double precision so far away actors keep their accuracy. Set with SetTransform. */
+	FMatrix Transform = FMatrix::Identity;
+	FMatrix NormalTransform = FMatrix::Identity;
+	bool bIsIdentity = true;
+
+	/** Mirroring transforms turn triangles inside out, so writers reverse their winding. */
+	bool bFlipsWinding = false;
+
+	/** Identifies the serialized instance in an FMeshExportChunkCache; empty when it is not cached. */
+	FString CacheKey;
+
+	/** The cached chunk of CacheKey, read while the scene is built; empty when the instance has to be formatted. */
+	TArray<uint8> CachedChunk;
+
+	void SetTransform(const FMatrix& InTransform);
+
+	FVector3f TransformPosition(const FVector3f& Position) const
+	{
+		return bIsIdentity ? Position : FVector3f(Transform.TransformPosition(FVector(Position)));
+	}
+
+	FVector3f TransformNormal(const FVector3f& Normal) const
+	{
+		return bIsIdentity ? Normal : FVector3f(NormalTransform.TransformVector(FVector(Normal)).GetSafeNormal());
+	}
+};
+
+/**
+ * Meshes placed in the world by transform, exported without merging them into one mesh first.
+ * Actors sharing a mesh and materials share one FMeshExportMeshData, so memory scales with the unique
+ * geometry; transforms are applied by the writers as they write each instance.
+ */
+struct SAFRAN_APP_API FMeshExportScene
+{
+	TArray<FMeshExportMeshData> Meshes;
+	TArray<FMeshExportInstance> Instances;
+
+	/** Triangles written once every instance is expanded. */
+	int64 NumInstancedTriangles() const;
+
+	void Reset();
+};
@@ -0,0 +1,366 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MeshExportOBJWriter.h"
+#include "MeshExportMeshData.h"
+#include "MeshExportTypes.h"
+#include "MeshExportWriter.h"
+#include "MeshExportChunkCache.h"
+#include "MeshExportReport.h"
+
+// UV or normal value as the digits it is written with, used to deduplicate vt/vn lines
+struct FQuantizedAttributeKey
+{
+    int64 X;
+    int64 Y;
+    int64 Z;
+
+    FQuantizedAttributeKey(float InX, float InY, float InZ, int32 Precision)
+        : X(Quantize(InX, Precision))
+        , Y(Quantize(InY, Precision))
+        , Z(Quantize(InZ, Precision))
+    {
+    }
+
+    // Values WriteFloat does not print itself keep their bits, above the range of quantized values, so they never merge
+    static int64 Quantize(float Value, int32 Precision)
+    {
+        int64 Fixed = 0;
+        if (MeshExportFormat::QuantizeFloat(Value, Precision, Fixed))
+        {
+            return Fixed;
+        }
+
+        uint32 Bits = 0;
+        FMemory::Memcpy(&Bits, &Value, sizeof(Bits));
+        return (1ll << 62) | Bits;
+    }
+
+    bool operator==(const FQuantizedAttributeKey& Other) const
+    {
+        return X == Other.X && Y == Other.Y && Z == Other.Z;
+    }
+
+    friend uint32 GetTypeHash(const FQuantizedAttributeKey& Key)
+    {
+        return HashCombine(HashCombine(GetTypeHash(Key.X), GetTypeHash(Key.Y)), GetTypeHash(Key.Z));
+    }
+};
+
+// Number of v/vt/vn lines written so far; OBJ indices count from the start of the file, not per object
+struct FOBJIndexBase
+{
+    int64 Positions = 0;
+    int64 UVs = 0;
+    int64 Normals = 0;
+};
+
+// Writes the v, vt, vn and f lines of one mesh, placed by Instance.
+// With bRelativeIndices, faces use negative indices counted back from their own vertices, so the lines read the same wherever they end up in the file.
+static void WriteMeshLines(FMeshExportFileWriter& Writer, const FMeshExportMeshData& Data, const FMeshExportInstance& Instance,
+    const FMeshExportSettings& Settings, bool bLogDetails, bool bRelativeIndices, FOBJIndexBase& Base, FMeshExportReport* Report)
+{
+    // Work out every vt/vn index up front. The formatting passes below only read these tables,
+    // so they can be split into chunks and run on any number of threads.
+
+    // UVs and normals get their own index spaces so identical values can share one vt/vn line.
+    // The Exported* arrays hold the wedge each written line takes its value from.
+    const int32 NumWedges = Data.NumWedges();
+    TArray<int32> ExportedUVs;
+    TArray<int32> ExportedNormals;
+    TArray<int32> WedgeToUVIndex;
+    TArray<int32> WedgeToNormalIndex;
+
+    // Values are deduplicated on the grid they are written at, so merging never changes the output
+    const bool bDeduplicate = Settings.bDeduplicateAttributes;
+    if (bDeduplicate)
+    {
+        MESH_EXPORT_STAGE_SCOPE(Report, TEXT("OBJ attribute deduplication"));
+        TMap<FQuantizedAttributeKey, int32> UVToIndex;
+        TMap<FQuantizedAttributeKey, int32> NormalToIndex;
+
+        WedgeToUVIndex.SetNumUninitialized(NumWedges);
+        WedgeToNormalIndex.SetNumUninitialized(NumWedges);
+
+        for (int32 Wedge = 0; Wedge < NumWedges; ++Wedge)
+        {
+            const FVector2f& UV = Data.WedgeUVs[Wedge];
+            int32& UVIndex = UVToIndex.FindOrAdd(FQuantizedAttributeKey(UV.X, 1.0f - UV.Y, 0.0f, Settings.FloatPrecision), INDEX_NONE);
+            if (UVIndex == INDEX_NONE)
+            {
+                UVIndex = ExportedUVs.Add(Wedge) + 1; // OBJ indices start at 1
+            }
+            WedgeToUVIndex[Wedge] = UVIndex;
+
+            const FVector3f Normal = Instance.TransformNormal(Data.WedgeNormals[Wedge]);
+            int32& NormalIndex = NormalToIndex.FindOrAdd(FQuantizedAttributeKey(Normal.X, Normal.Z, Normal.Y, Settings.FloatPrecision), INDEX_NONE);
+            if (NormalIndex == INDEX_NONE)
+            {
+                NormalIndex = ExportedNormals.Add(Wedge) + 1;
+            }
+            WedgeToNormalIndex[Wedge] = NormalIndex;
+        }
+
+        if (bLogDetails)
+        {
+            UE_LOG(LogTemp, Log, TEXT("Deduplicated %d vertex instances to %d UVs and %d normals"),
+                NumWedges, ExportedUVs.Num(), ExportedNormals.Num());
+        }
+    }
+
+    const int32 NumUVs = bDeduplicate ? ExportedUVs.Num() : NumWedges;
+    const int32 NumNormals = bDeduplicate ? ExportedNormals.Num() : NumWedges;
+
+    // Added to the 1-based indices of this mesh
+    const int64 PositionOffset = bRelativeIndices ? -1 - Data.Positions.Num() : Base.Positions;
+    const int64 UVOffset = bRelativeIndices ? -1 - NumUVs : Base.UVs;
+    const int64 NormalOffset = bRelativeIndices ? -1 - NumNormals : Base.Normals;
+
+    const int32 Precision = Settings.FloatPrecision;
+    const bool bTrim = Settings.bTrimTrailingZeros;
+    const bool bParallel = Settings.bParallelSerialization;
+
+    // Export vertex positions
+    {
+        MESH_EXPORT_STAGE_SCOPE(Report, TEXT("OBJ positions"), &Writer);
+        Writer.WriteChunked(Data.Positions.Num(), [&](FMeshExportTextBuffer& Text, int32 Begin, int32 End)
+        {
+            for (int32 Index = Begin; Index < End; ++Index)
+            {
+                const FVector3f Pos = Instance.TransformPosition(Data.Positions[Index]);
+                // Convert from UE coordinates (Z-up) to OBJ coordinates (Y-up)
+                Text.Append("v ");
+                Text.AppendFloat(Pos.X, Precision, bTrim);
+                Text.AppendChar(' ');
+                Text.AppendFloat(Pos.Z, Precision, bTrim);
+                Text.AppendChar(' ');
+                Text.AppendFloat(Pos.Y, Precision, bTrim);
+                Text.AppendChar('\n');
+            }
+        }, bParallel);
+        Writer.Write("\n", 1);
+    }
+
+    // Export texture coordinates
+    {
+        MESH_EXPORT_STAGE_SCOPE(Report, TEXT("OBJ UVs"), &Writer);
+        Writer.WriteChunked(NumUVs, [&](FMeshExportTextBuffer& Text, int32 Begin, int32 End)
+        {
+            for (int32 Index = Begin; Index < End; ++Index)
+            {
+                const FVector2f& UV = Data.WedgeUVs[bDeduplicate ? ExportedUVs[Index] : Index];
+                Text.Append("vt ");
+                Text.AppendFloat(UV.X, Precision, bTrim);
+                Text.AppendChar(' ');
+                Text.AppendFloat(1.0f - UV.Y, Precision, bTrim);
+                Text.AppendChar('\n');
+            }
+        }, bParallel);
+        Writer.Write("\n", 1);
+    }
+
+    // Export normals
+    {
+        MESH_EXPORT_STAGE_SCOPE(Report, TEXT("OBJ normals"), &Writer);
+        Writer.WriteChunked(NumNormals, [&](FMeshExportTextBuffer& Text, int32 Begin, int32 End)
+        {
+            for (int32 Index = Begin; Index < End; ++Index)
+            {
+                const FVector3f Normal = Instance.TransformNormal(Data.WedgeNormals[bDeduplicate ? ExportedNormals[Index] : Index]);
+                // Convert from UE coordinates to OBJ coordinates
+                Text.Append("vn ");
+                Text.AppendFloat(Normal.X, Precision, bTrim);
+                Text.AppendChar(' ');
+                Text.AppendFloat(Normal.Z, Precision, bTrim);
+                Text.AppendChar(' ');
+                Text.AppendFloat(Normal.Y, Precision, bTrim);
+                Text.AppendChar('\n');
+            }
+        }, bParallel);
+        Writer.Write("\n", 1);
+    }
+
+    if (bLogDetails)
+    {
+        UE_LOG(LogTemp, Log, TEXT("Mesh has %d materials/sections"), Data.Sections.Num());
+    }
+
+    // Mirrored instances write their corners in reverse order to keep faces pointing outwards
+    const int32 CornerOrder[2][3] = { { 0, 1, 2 }, { 0, 2, 1 } };
+    const int32* Corners = CornerOrder[Instance.bFlipsWinding ? 1 : 0];
+
+    // Export faces grouped by material
+    {
+        MESH_EXPORT_STAGE_SCOPE(Report, TEXT("OBJ faces"), &Writer);
+        for (const FMeshExportSection& Section : Data.Sections)
+        {
+            Writer.Write(FString::Printf(TEXT("\n# Material: %s\n"), *Section.MaterialName));
+            Writer.Write(FString::Printf(TEXT("usemtl %s\n"), *Section.MaterialName));
+
+            const TArray<int32>& Indices = Section.Indices;
+            Writer.WriteChunked(Indices.Num() / 3, [&](FMeshExportTextBuffer& Text, int32 Begin, int32 End)
+            {
+                for (int32 Triangle = Begin; Triangle < End; ++Triangle)
+                {
+                    Text.AppendChar('f');
+                    for (int32 i = 0; i < 3; i++)
+                    {
+                        const int32 Wedge = Indices[Triangle * 3 + Corners[i]];
+
+                        Text.AppendChar(' ');
+                        Text.AppendInt(PositionOffset + Data.WedgePositions[Wedge] + 1);
+                        Text.AppendChar('/');
+                        Text.AppendInt(UVOffset + (bDeduplicate ? WedgeToUVIndex[Wedge] : Wedge + 1));
+                        Text.AppendChar('/');
+                        Text.AppendInt(NormalOffset + (bDeduplicate ? WedgeToNormalIndex[Wedge] : Wedge + 1));
+                    }
+                    Text.AppendChar('\n');
+                }
+            }, bParallel);
+
+            if (bLogDetails)
+            {
+                UE_LOG(LogTemp, Log, TEXT("Exported %d faces for material: %s"), Indices.Num() / 3, *Section.MaterialName);
+            }
+        }
+    }
+
+    Base.Positions += Data.Positions.Num();
+    Base.UVs += NumUVs;
+    Base.Normals += NumNormals;
+
+    if (Report)
+    {
+        Report->VerticesWritten += Data.Positions.Num();
+        Report->TrianglesWritten += Data.NumTriangles();
+    }
+}
+
+// Upper bound of the elements WriteMeshLines formats, used to report progress
+static int64 CountProgressElements(const FMeshExportMeshData& Data)
+{
+    return static_cast<int64>(Data.Positions.Num()) + static_cast<int64>(Data.NumWedges()) * 2 + Data.NumTriangles();
+}
+
+// Flushes the remaining data and closes the file, which only replaces FilePath if the export completed
+static bool FinishFile(FMeshExportFileWriter& Writer, const FString& FilePath)
+{
+    const bool bCancelled = Writer.WasCancelled();
+    bool bSuccess = Writer.Close() && !bCancelled;
+
+    if (bCancelled)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("OBJ export cancelled, discarded partial file: %s"), *FilePath);
+    }
+    else if (!bSuccess)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to save OBJ file: %s"), *FilePath);
+    }
+
+    return bSuccess;
+}
+
+bool FMeshExportOBJWriter::Write(const FMeshExportMeshData& Data, const FString& FilePath, const FString& MTLFileName,
+    const FMeshExportSettings& Settings, FMeshExportProgress* Progress, FMeshExportReport* Report)
+{
+    UE_LOG(LogTemp, Log, TEXT("Exporting %d vertices, %d triangles"), Data.Positions.Num(), Data.NumTriangles());
+
+    // Stream the file out while it is generated instead of building it in memory
+    FMeshExportFileWriter Writer;
+    MESH_EXPORT_STAGE_SCOPE(Report, TEXT("Write OBJ"), &Writer, true);
+    if (!Writer.Open(FilePath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to save OBJ file: %s"), *FilePath);
+        return false;
+    }
+
+    if (Progress)
+    {
+        Writer.SetProgress(Progress, CountProgressElements(Data));
+    }
+
+    Writer.Write(TEXT("# Exported from Unreal Engine 5\n"));
+    Writer.Write(FString::Printf(TEXT("# Mesh: %s\n"), *Data.Name));
+    Writer.Write(FString::Printf(TEXT("mtllib %s\n\n"), *MTLFileName));
+
+    FOBJIndexBase Base;
+    WriteMeshLines(Writer, Data, FMeshExportInstance(), Settings, true, false, Base, Report);
+
+    return FinishFile(Writer, FilePath);
+}
+
+bool FMeshExportOBJWriter::WriteScene(const FMeshExportScene& Scene, const FString& FilePath, const FString& MTLFileName,
+    const FMeshExportSettings& Settings, FMeshExportProgress* Progress, FMeshExportChunkCache* Cache, FMeshExportReport* Report)
+{
+    UE_LOG(LogTemp, Log, TEXT("Exporting %d objects using %d meshes, %lld triangles"),
+        Scene.Instances.Num(), Scene.Meshes.Num(), Scene.NumInstancedTriangles());
+
+    FMeshExportFileWriter Writer;
+    MESH_EXPORT_STAGE_SCOPE(Report, TEXT("Write OBJ"), &Writer, true);
+    if (!Writer.Open(FilePath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to save OBJ file: %s"), *FilePath);
+        return false;
+    }
+
+    if (Progress)
+    {
+        int64 TotalElements = 0;
+        for (const FMeshExportInstance& Instance : Scene.Instances)
+        {
+            if (Instance.CachedChunk.Num() == 0)
+            {
+                TotalElements += CountProgressElements(Scene.Meshes[Instance.MeshIndex]);
+            }
+        }
+        Writer.SetProgress(Progress, TotalElements);
+    }
+
+    Writer.Write(TEXT("# Exported from Unreal Engine 5\n"));
+    Writer.Write(FString::Printf(TEXT("# Objects: %d\n"), Scene.Instances.Num()));
+    Writer.Write(FString::Printf(TEXT("mtllib %s\n\n"), *MTLFileName));
+
+    // One object and group per instance, each with its own vertices in world space
+    FOBJIndexBase Base;
+    int32 NumReused = 0;
+    for (const FMeshExportInstance& Instance : Scene.Instances)
+    {
+        if (Writer.WasCancelled())
+        {
+            break;
+        }
+
+        // With a cache every object uses relative indices, so a chunk from a previous export can be copied in as is
+        const bool bCached = Cache && !Instance.CacheKey.IsEmpty();
+        if (bCached && Instance.CachedChunk.Num() > 0)
+        {
+            MESH_EXPORT_STAGE_SCOPE(Report, TEXT("OBJ cached objects"), &Writer);
+            Writer.Write(Instance.CachedChunk.GetData(), Instance.CachedChunk.Num());
+            Cache->MarkUsed(Instance.CacheKey);
+            NumReused++;
+            continue;
+        }
+
+        // Chunks were loaded while the scene was built, every instance without one has its mesh read
+        const FMeshExportMeshData& Data = Scene.Meshes[Instance.MeshIndex];
+        if (bCached)
+        {
+            Writer.BeginCapture(Cache->GetChunkPath(Instance.CacheKey));
+        }
+
+        Writer.Write(FString::Printf(TEXT("o %s\ng %s\n"), *Instance.Name, *Instance.Name));
+        WriteMeshLines(Writer, Data, Instance, Settings, false, Cache != nullptr, Base, Report);
+        Writer.Write("\n", 1);
+
+        if (bCached && Writer.EndCapture(!Writer.WasCancelled()))
+        {
+            Cache->MarkUsed(Instance.CacheKey);
+        }
+    }
+
+    if (Cache)
+    {
+        UE_LOG(LogTemp, Log, TEXT("Reused %d of %d objects from the geometry cache"), NumReused, Scene.Instances.Num());
+    }
+
+    return FinishFile(Writer, FilePath);
+}
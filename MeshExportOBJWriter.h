@@ -0,0 +1,35 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FMeshExportMeshData;
+struct FMeshExportScene;
+struct FMeshExportSettings;
+class FMeshExportProgress;
+class FMeshExportChunkCache;
+struct FMeshExportReport;
+
+/** Writes FMeshExportMeshData as Wavefront OBJ text. */
+struct SAFRAN_APP_API FMeshExportOBJWriter
+{
+	/**
+	 * Writes Data to FilePath with an mtllib reference to MTLFileName. Only touches the data passed in,
+	 * so it can run on any thread. Progress, when given, is updated as sections are written and checked for cancellation;
+	 * a cancelled export discards the partial file, keeps any previous file at FilePath and returns false.
+	 * Report, when given, receives the time and bytes of each kind of line and must not be used by another thread meanwhile.
+	 */
+	static bool Write(const FMeshExportMeshData& Data, const FString& FilePath, const FString& MTLFileName,
+		const FMeshExportSettings& Settings, FMeshExportProgress* Progress = nullptr, FMeshExportReport* Report = nullptr);
+
+	/**
+	 * Writes every instance of Scene as its own "o"/"g" object with world space vertices, in instance order.
+	 * Same threading and progress rules as Write.
+	 * With a Cache, instances with a CacheKey are written from their CachedChunk when it was loaded and saved to the cache
+	 * otherwise; all faces then use relative indices. Instances whose mesh was left empty must have a CachedChunk.
+	 */
+	static bool WriteScene(const FMeshExportScene& Scene, const FString& FilePath, const FString& MTLFileName,
+		const FMeshExportSettings& Settings, FMeshExportProgress* Progress = nullptr, FMeshExportChunkCache* Cache = nullptr,
+		FMeshExportReport* Report = nullptr);
+};
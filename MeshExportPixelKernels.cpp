@@ -0,0 +1,217 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MeshExportPixelKernels.h"
+
+#if PLATFORM_CPU_X86_FAMILY
+#include <emmintrin.h>
+#define MESH_EXPORT_PIXELS_SSE2 1
+#define MESH_EXPORT_PIXELS_NEON 0
+#elif PLATFORM_CPU_ARM_FAMILY && PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+#include <arm_neon.h>
+#define MESH_EXPORT_PIXELS_SSE2 0
+#define MESH_EXPORT_PIXELS_NEON 1
+#else
+#define MESH_EXPORT_PIXELS_SSE2 0
+#define MESH_EXPORT_PIXELS_NEON 0
+#endif
+
+namespace MeshExportPixels
+{
+    void ExpandGray8ToBGRA8(const uint8* Src, uint8* Dst, int64 NumPixels)
+    {
+        int64 Pixel = 0;
+
+#if MESH_EXPORT_PIXELS_SSE2
+        const __m128i Opaque = _mm_set1_epi8(static_cast<char>(0xFF));
+        for (; Pixel + 16 <= NumPixels; Pixel += 16)
+        {
+            const __m128i Gray = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + Pixel));
+
+            // g g pairs and g a pairs, interleaved into g g g a pixels
+            const __m128i GrayGrayLo = _mm_unpacklo_epi8(Gray, Gray);
+            const __m128i GrayGrayHi = _mm_unpackhi_epi8(Gray, Gray);
+            const __m128i GrayAlphaLo = _mm_unpacklo_epi8(Gray, Opaque);
+            const __m128i GrayAlphaHi = _mm_unpackhi_epi8(Gray, Opaque);
+
+            __m128i* Out = reinterpret_cast<__m128i*>(Dst + Pixel * 4);
+            _mm_storeu_si128(Out + 0, _mm_unpacklo_epi16(GrayGrayLo, GrayAlphaLo));
+            _mm_storeu_si128(Out + 1, _mm_unpackhi_epi16(GrayGrayLo, GrayAlphaLo));
+            _mm_storeu_si128(Out + 2, _mm_unpacklo_epi16(GrayGrayHi, GrayAlphaHi));
+            _mm_storeu_si128(Out + 3, _mm_unpackhi_epi16(GrayGrayHi, GrayAlphaHi));
+        }
+#elif MESH_EXPORT_PIXELS_NEON
+        const uint8x16_t Opaque = vdupq_n_u8(0xFF);
+        for (; Pixel + 16 <= NumPixels; Pixel += 16)
+        {
+            const uint8x16_t Gray = vld1q_u8(Src + Pixel);
+            uint8x16x4_t Out;
+            Out.val[0] = Gray;
+            Out.val[1] = Gray;
+            Out.val[2] = Gray;
+            Out.val[3] = Opaque;
+            vst4q_u8(Dst + Pixel * 4, Out);
+        }
+#endif
+
+        for (; Pixel < NumPixels; ++Pixel)
+        {
+            uint8* Out = Dst + Pixel * 4;
+            Out[0] = Out[1] = Out[2] = Src[Pixel];
+            Out[3] = 0xFF;
+        }
+    }
+
+    void ExpandGray16ToBGRA8(const uint16* Src, uint8* Dst, int64 NumPixels)
+    {
+        int64 Pixel = 0;
+
+#if MESH_EXPORT_PIXELS_SSE2
+        const __m128i Opaque = _mm_set1_epi8(static_cast<char>(0xFF));
+        for (; Pixel + 16 <= NumPixels; Pixel += 16)
+        {
+            // Keep the high byte of every sample and pack 16 of them into one register
+            const __m128i Lo = _mm_srli_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + Pixel)), 8);
+            const __m128i Hi = _mm_srli_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + Pixel + 8)), 8);
+            const __m128i Gray = _mm_packus_epi16(Lo, Hi);
+
+            const __m128i GrayGrayLo = _mm_unpacklo_epi8(Gray, Gray);
+            const __m128i GrayGrayHi = _mm_unpackhi_epi8(Gray, Gray);
+            const __m128i GrayAlphaLo = _mm_unpacklo_epi8(Gray, Opaque);
+            const __m128i GrayAlphaHi = _mm_unpackhi_epi8(Gray, Opaque);
+
+            __m128i* Out = reinterpret_cast<__m128i*>(Dst + Pixel * 4);
+            _mm_storeu_si128(Out + 0, _mm_unpacklo_epi16(GrayGrayLo, GrayAlphaLo));
+            _mm_storeu_si128(Out + 1, _mm_unpackhi_epi16(GrayGrayLo, GrayAlphaLo));
+            _mm_storeu_si128(Out + 2, _mm_unpacklo_epi16(GrayGrayHi, GrayAlphaHi));
+            _mm_storeu_si128(Out + 3, _mm_unpackhi_epi16(GrayGrayHi, GrayAlphaHi));
+        }
+#elif MESH_EXPORT_PIXELS_NEON
+        const uint8x16_t Opaque = vdupq_n_u8(0xFF);
+        for (; Pixel + 16 <= NumPixels; Pixel += 16)
+        {
+            const uint8x16_t Gray = vcombine_u8(vshrn_n_u16(vld1q_u16(Src + Pixel), 8), vshrn_n_u16(vld1q_u16(Src + Pixel + 8), 8));
+            uint8x16x4_t Out;
+            Out.val[0] = Gray;
+            Out.val[1] = Gray;
+            Out.val[2] = Gray;
+            Out.val[3] = Opaque;
+            vst4q_u8(Dst + Pixel * 4, Out);
+        }
+#endif
+
+        for (; Pixel < NumPixels; ++Pixel)
+        {
+            uint8* Out = Dst + Pixel * 4;
+            Out[0] = Out[1] = Out[2] = static_cast<uint8>(Src[Pixel] >> 8);
+            Out[3] = 0xFF;
+        }
+    }
+
+    void ConvertRGBA16ToBGRA8(const uint16* Src, uint8* Dst, int64 NumPixels)
+    {
+        int64 Pixel = 0;
+
+#if MESH_EXPORT_PIXELS_SSE2
+        const __m128i GreenAlphaMask = _mm_set1_epi32(static_cast<int>(0xFF00FF00));
+        const __m128i LowByteMask = _mm_set1_epi32(0x000000FF);
+        for (; Pixel + 4 <= NumPixels; Pixel += 4)
+        {
+            // Two pixels per load; keep the high bytes to get four RGBA8 pixels
+            const __m128i Lo = _mm_srli_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + Pixel * 4)), 8);
+            const __m128i Hi = _mm_srli_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + Pixel * 4 + 8)), 8);
+            const __m128i RGBA = _mm_packus_epi16(Lo, Hi);
+
+            // Swap bytes 0 and 2 of every pixel: keep G and A, move R up and B down
+            const __m128i GreenAlpha = _mm_and_si128(RGBA, GreenAlphaMask);
+            const __m128i Red = _mm_slli_epi32(_mm_and_si128(RGBA, LowByteMask), 16);
+            const __m128i Blue = _mm_and_si128(_mm_srli_epi32(RGBA, 16), LowByteMask);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + Pixel * 4), _mm_or_si128(GreenAlpha, _mm_or_si128(Red, Blue)));
+        }
+#elif MESH_EXPORT_PIXELS_NEON
+        for (; Pixel + 8 <= NumPixels; Pixel += 8)
+        {
+            const uint16x8x4_t In = vld4q_u16(Src + Pixel * 4);
+            uint8x8x4_t Out;
+            Out.val[0] = vshrn_n_u16(In.val[2], 8);
+            Out.val[1] = vshrn_n_u16(In.val[1], 8);
+            Out.val[2] = vshrn_n_u16(In.val[0], 8);
+            Out.val[3] = vshrn_n_u16(In.val[3], 8);
+            vst4_u8(Dst + Pixel * 4, Out);
+        }
+#endif
+
+        for (; Pixel < NumPixels; ++Pixel)
+        {
+            const uint16* In = Src + Pixel * 4;
+            uint8* Out = Dst + Pixel * 4;
+            Out[0] = static_cast<uint8>(In[2] >> 8);
+            Out[1] = static_cast<uint8>(In[1] >> 8);
+            Out[2] = static_cast<uint8>(In[0] >> 8);
+            Out[3] = static_cast<uint8>(In[3] >> 8);
+        }
+    }
+
+    void HalveBGRA8(const uint8* Src, int32 SrcWidth, int32 SrcHeight, uint8* Dst)
+    {
+        const int32 DstWidth = FMath::Max(SrcWidth / 2, 1);
+        const int32 DstHeight = FMath::Max(SrcHeight / 2, 1);
+        const int64 SrcPitch = static_cast<int64>(SrcWidth) * 4;
+
+        // Whole pairs of source columns; a single column is paired with itself by the scalar loop
+        const int32 PairedWidth = SrcWidth / 2;
+
+        for (int32 Y = 0; Y < DstHeight; ++Y)
+        {
+            const uint8* Row0 = Src + FMath::Min(Y * 2, SrcHeight - 1) * SrcPitch;
+            const uint8* Row1 = Src + FMath::Min(Y * 2 + 1, SrcHeight - 1) * SrcPitch;
+            uint8* Out = Dst + static_cast<int64>(Y) * DstWidth * 4;
+            int32 X = 0;
+
+#if MESH_EXPORT_PIXELS_SSE2
+            const __m128i Zero = _mm_setzero_si128();
+            const __m128i Rounding = _mm_set1_epi16(2);
+            for (; X + 2 <= PairedWidth; X += 2)
+            {
+                // Four source pixels from each row make two output pixels
+                const __m128i Top = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Row0 + X * 8));
+                const __m128i Bottom = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Row1 + X * 8));
+                const __m128i SumLo = _mm_add_epi16(_mm_unpacklo_epi8(Top, Zero), _mm_unpacklo_epi8(Bottom, Zero));
+                const __m128i SumHi = _mm_add_epi16(_mm_unpackhi_epi8(Top, Zero), _mm_unpackhi_epi8(Bottom, Zero));
+
+                // Each half holds two neighbouring pixels; fold them onto each other
+                const __m128i PairLo = _mm_add_epi16(SumLo, _mm_srli_si128(SumLo, 8));
+                const __m128i PairHi = _mm_add_epi16(SumHi, _mm_srli_si128(SumHi, 8));
+                const __m128i Sum = _mm_unpacklo_epi64(PairLo, PairHi);
+
+                const __m128i Average = _mm_srli_epi16(_mm_add_epi16(Sum, Rounding), 2);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(Out + X * 4), _mm_packus_epi16(Average, Average));
+            }
+#elif MESH_EXPORT_PIXELS_NEON
+            for (; X + 8 <= PairedWidth; X += 8)
+            {
+                // Sixteen source pixels from each row, split into channels, make eight output pixels
+                const uint8x16x4_t Top = vld4q_u8(Row0 + X * 8);
+                const uint8x16x4_t Bottom = vld4q_u8(Row1 + X * 8);
+                uint8x8x4_t Average;
+                for (int32 Channel = 0; Channel < 4; ++Channel)
+                {
+                    const uint16x8_t Sum = vpadalq_u8(vpaddlq_u8(Top.val[Channel]), Bottom.val[Channel]);
+                    Average.val[Channel] = vrshrn_n_u16(Sum, 2);
+                }
+                vst4_u8(Out + X * 4, Average);
+            }
+#endif
+
+            for (; X < DstWidth; ++X)
+            {
+                const int64 Left = static_cast<int64>(X * 2) * 4;
+                const int64 Right = static_cast<int64>(FMath::Min(X * 2 + 1, SrcWidth - 1)) * 4;
+                for (int32 Channel = 0; Channel < 4; ++Channel)
+                {
+                    const int32 Sum = Row0[Left + Channel] + Row0[Right + Channel] + Row1[Left + Channel] + Row1[Right + Channel];
+                    Out[X * 4 + Channel] = static_cast<uint8>((Sum + 2) >> 2);
+                }
+            }
+        }
+    }
+}
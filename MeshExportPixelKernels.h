@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Pixel conversion kernels producing 8-bit BGRA, the layout the image wrappers take and FColor uses.
+ * Each has an SSE2 / NEON path with a scalar tail, and none of them allocates.
+ * Src and Dst must not overlap; unless stated otherwise Dst must have room for NumPixels * 4 bytes.
+ */
+namespace MeshExportPixels
+{
+	/** G8 -> BGRA8, gray replicated to the color channels with opaque alpha. */
+	SAFRAN_APP_API void ExpandGray8ToBGRA8(const uint8* Src, uint8* Dst, int64 NumPixels);
+
+	/** G16 -> BGRA8, keeping the high byte of each sample. */
+	SAFRAN_APP_API void ExpandGray16ToBGRA8(const uint16* Src, uint8* Dst, int64 NumPixels);
+
+	/** RGBA16 -> BGRA8, keeping the high byte of each channel and swapping red and blue. */
+	SAFRAN_APP_API void ConvertRGBA16ToBGRA8(const uint16* Src, uint8* Dst, int64 NumPixels);
+
+	/**
+	 * BGRA8 -> BGRA8 at half the size, each pixel the rounded average of a 2x2 block. A side of 1 stays 1 and the last
+	 * row or column of an odd side is dropped. Dst must have room for max(SrcWidth / 2, 1) * max(SrcHeight / 2, 1) pixels.
+	 */
+	SAFRAN_APP_API void HalveBGRA8(const uint8* Src, int32 SrcWidth, int32 SrcHeight, uint8* Dst);
+}
@@ -0,0 +1,159 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MeshExportReport.h"
+#include "MeshExportWriter.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/JsonWriter.h"
+
+void FMeshExportReport::Reset()
+{
+    FilePath.Reset();
+    bSuccess = false;
+    TotalSeconds = 0.0;
+    PeakUsedPhysical = 0;
+    MaxUsedPhysical = 0;
+    VerticesWritten = 0;
+    TrianglesWritten = 0;
+    Stages.Reset();
+    Textures.Reset();
+}
+
+FMeshExportStageReport& FMeshExportReport::FindOrAddStage(const TCHAR* Name)
+{
+    if (FMeshExportStageReport* Stage = Stages.FindByPredicate([Name](const FMeshExportStageReport& Existing) { return Existing.Name == Name; }))
+    {
+        return *Stage;
+    }
+
+    FMeshExportStageReport& Stage = Stages.AddDefaulted_GetRef();
+    Stage.Name = Name;
+    return Stage;
+}
+
+void FMeshExportReport::AddStage(const TCHAR* Name, double Seconds, int64 BytesWritten, int32 Count)
+{
+    FMeshExportStageReport& Stage = FindOrAddStage(Name);
+    Stage.Seconds += Seconds;
+    Stage.Count += Count;
+    Stage.BytesWritten += BytesWritten;
+}
+
+void FMeshExportReport::AddStageMemory(const TCHAR* Name, int64 StartUsedPhysical, int64 EndUsedPhysical)
+{
+    FMeshExportStageReport& Stage = FindOrAddStage(Name);
+    const int64 Delta = EndUsedPhysical - StartUsedPhysical;
+    Stage.UsedPhysicalDelta = Stage.bMeasuredMemory ? FMath::Max(Stage.UsedPhysicalDelta, Delta) : Delta;
+    Stage.bMeasuredMemory = true;
+    MaxUsedPhysical = FMath::Max(MaxUsedPhysical, FMath::Max(StartUsedPhysical, EndUsedPhysical));
+}
+
+void FMeshExportReport::Finish(double InTotalSeconds, bool bInSuccess)
+{
+    TotalSeconds = InTotalSeconds;
+    bSuccess = bInSuccess;
+    PeakUsedPhysical = GetPeakUsedPhysical();
+    MaxUsedPhysical = FMath::Max(MaxUsedPhysical, GetUsedPhysical());
+}
+
+FString FMeshExportReport::ToJson() const
+{
+    FString Text;
+    TSharedRef<TJsonWriter<>> Json = TJsonWriterFactory<>::Create(&Text);
+    Json->WriteObjectStart();
+    Json->WriteValue(TEXT("file"), FilePath);
+    Json->WriteValue(TEXT("success"), bSuccess);
+    Json->WriteValue(TEXT("totalSeconds"), TotalSeconds);
+    Json->WriteValue(TEXT("peakUsedPhysical"), PeakUsedPhysical);
+    Json->WriteValue(TEXT("maxUsedPhysical"), MaxUsedPhysical);
+    Json->WriteValue(TEXT("verticesWritten"), VerticesWritten);
+    Json->WriteValue(TEXT("trianglesWritten"), TrianglesWritten);
+
+    Json->WriteArrayStart(TEXT("stages"));
+    for (const FMeshExportStageReport& Stage : Stages)
+    {
+        Json->WriteObjectStart();
+        Json->WriteValue(TEXT("name"), Stage.Name);
+        Json->WriteValue(TEXT("seconds"), Stage.Seconds);
+        Json->WriteValue(TEXT("count"), Stage.Count);
+        Json->WriteValue(TEXT("bytesWritten"), Stage.BytesWritten);
+        if (Stage.bMeasuredMemory)
+        {
+            Json->WriteValue(TEXT("usedPhysicalDelta"), Stage.UsedPhysicalDelta);
+        }
+        Json->WriteObjectEnd();
+    }
+    Json->WriteArrayEnd();
+
+    Json->WriteArrayStart(TEXT("textures"));
+    for (const FMeshExportTextureReport& Texture : Textures)
+    {
+        Json->WriteObjectStart();
+        Json->WriteValue(TEXT("name"), Texture.Name);
+        Json->WriteValue(TEXT("file"), Texture.FileName);
+        Json->WriteValue(TEXT("decodeSeconds"), Texture.DecodeSeconds);
+        Json->WriteValue(TEXT("encodeSeconds"), Texture.EncodeSeconds);
+        Json->WriteValue(TEXT("writeSeconds"), Texture.WriteSeconds);
+        Json->WriteValue(TEXT("bytesWritten"), Texture.BytesWritten);
+        Json->WriteValue(TEXT("fromCache"), Texture.bFromCache);
+        Json->WriteObjectEnd();
+    }
+    Json->WriteArrayEnd();
+
+    Json->WriteObjectEnd();
+    Json->Close();
+    return Text;
+}
+
+bool FMeshExportReport::SaveJson(const FString& JsonPath) const
+{
+    if (!FFileHelper::SaveStringToFile(ToJson(), *JsonPath))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Failed to save export report: %s"), *JsonPath);
+        return false;
+    }
+    return true;
+}
+
+int64 FMeshExportReport::GetPeakUsedPhysical()
+{
+    return static_cast<int64>(FPlatformMemory::GetStats().PeakUsedPhysical);
+}
+
+int64 FMeshExportReport::GetUsedPhysical()
+{
+    return static_cast<int64>(FPlatformMemory::GetStats().UsedPhysical);
+}
+
+FMeshExportStageTimer::FMeshExportStageTimer(FMeshExportReport* InReport, const TCHAR* InName, const FMeshExportFileWriter* InWriter, bool bInRecordMemory)
+    : Report(InReport)
+    , Name(InName)
+    , Writer(InWriter)
+    , bRecordMemory(bInRecordMemory)
+    , StartTime(FPlatformTime::Seconds())
+{
+    if (Writer)
+    {
+        StartBytes = Writer->GetBytesWritten();
+    }
+    if (Report && bRecordMemory)
+    {
+        StartUsedPhysical = FMeshExportReport::GetUsedPhysical();
+    }
+}
+
+FMeshExportStageTimer::~FMeshExportStageTimer()
+{
+    if (!Report)
+    {
+        return;
+    }
+
+    const int64 Bytes = ExtraBytes + (Writer ? Writer->GetBytesWritten() - StartBytes : 0);
+    Report->AddStage(Name, FPlatformTime::Seconds() - StartTime, Bytes);
+    if (bRecordMemory)
+    {
+        Report->AddStageMemory(Name, StartUsedPhysical, FMeshExportReport::GetUsedPhysical());
+    }
+}
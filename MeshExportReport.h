@@ -0,0 +1,168 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "MeshExportReport.generated.h"
+
+class FMeshExportFileWriter;
+
+/** Time, output and memory of one stage of an export, summed over every time the stage ran. */
+USTRUCT(BlueprintType)
+struct SAFRAN_APP_API FMeshExportStageReport
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Mesh Export")
+	FString Name;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Mesh Export")
+	double Seconds = 0.0;
+
+	/** Number of times the stage ran, such as once per mesh or per texture. */
+	UPROPERTY(BlueprintReadOnly, Category = "Mesh Export")
+	int32 Count = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Mesh Export")
+	int64 BytesWritten = 0;
+
+	/**
+	 * Used physical memory of the process at the end of a run of the stage minus at its start, the largest over every
+	 * run. Negative when the stage freed more than it allocated. Only set when bMeasuredMemory is.
+	 */
+	UPROPERTY(BlueprintReadOnly, Category = "Mesh Export")
+	int64 UsedPhysicalDelta = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Mesh Export")
+	bool bMeasuredMemory = false;
+};
+
+/** What happened to one exported texture. */
+USTRUCT(BlueprintType)
+struct SAFRAN_APP_API FMeshExportTextureReport
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Mesh Export")
+	FString Name;
+
+	/** Written file relative to the Textures folder, empty if the texture could not be exported. */
+	UPROPERTY(BlueprintReadOnly, Category = "Mesh Export")
+	FString FileName;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Mesh Export")
+	double DecodeSeconds = 0.0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Mesh Export")
+	double EncodeSeconds = 0.0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Mesh Export")
+	double WriteSeconds = 0.0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Mesh Export")
+	int64 BytesWritten = 0;
+
+	/** The file of a previous export was still valid and kept. */
+	UPROPERTY(BlueprintReadOnly, Category = "Mesh Export")
+	bool bFromCache = false;
+};
+
+/**
+ * Per-stage timings of one export, filled in as the export runs and optionally saved as JSON next to the exported
+ * file. Only one thread adds to a report at a time; work spread over workers is summed up before it is added.
+ */
+USTRUCT(BlueprintType)
+struct SAFRAN_APP_API FMeshExportReport
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Mesh Export")
+	FString FilePath;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Mesh Export")
+	bool bSuccess = false;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Mesh Export")
+	double TotalSeconds = 0.0;
+
+	/** Peak physical memory of the process since it started, read at the end of the export. */
+	UPROPERTY(BlueprintReadOnly, Category = "Mesh Export")
+	int64 PeakUsedPhysical = 0;
+
+	/**
+	 * Largest used physical memory of the process sampled during the export, at the start and end of every stage that
+	 * measures memory and when the export finished. Unlike PeakUsedPhysical it does not include earlier exports.
+	 */
+	UPROPERTY(BlueprintReadOnly, Category = "Mesh Export")
+	int64 MaxUsedPhysical = 0;
+
+	/** Vertices and triangles the writers formatted; geometry copied from a cache is not counted. */
+	UPROPERTY(BlueprintReadOnly, Category = "Mesh Export")
+	int64 VerticesWritten = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Mesh Export")
+	int64 TrianglesWritten = 0;
+
+	/** In the order the stages first ran. Stages can nest, "OBJ faces" is also part of "Write OBJ" for instance. */
+	UPROPERTY(BlueprintReadOnly, Category = "Mesh Export")
+	TArray<FMeshExportStageReport> Stages;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Mesh Export")
+	TArray<FMeshExportTextureReport> Textures;
+
+	void Reset();
+
+	/** Adds one run of the named stage. */
+	void AddStage(const TCHAR* Name, double Seconds, int64 BytesWritten = 0, int32 Count = 1);
+
+	/** Adds the used physical memory of the process at the start and end of one run of the named stage. */
+	void AddStageMemory(const TCHAR* Name, int64 StartUsedPhysical, int64 EndUsedPhysical);
+
+	/** Sets TotalSeconds, bSuccess and the memory peaks once the export is over. */
+	void Finish(double InTotalSeconds, bool bInSuccess);
+
+	FString ToJson() const;
+	bool SaveJson(const FString& JsonPath) const;
+
+	/** Peak physical memory used by the process so far. */
+	static int64 GetPeakUsedPhysical();
+
+	/** Physical memory the process uses right now. */
+	static int64 GetUsedPhysical();
+
+private:
+	FMeshExportStageReport& FindOrAddStage(const TCHAR* Name);
+};
+
+/**
+ * Adds the time until it goes out of scope to a stage of Report, which may be null. With a Writer, the bytes it wrote
+ * in the meantime are added too; bRecordMemory also records how much used physical memory changed over the scope,
+ * which is too slow to query in inner loops.
+ */
+class SAFRAN_APP_API FMeshExportStageTimer
+{
+public:
+	FMeshExportStageTimer(FMeshExportReport* InReport, const TCHAR* InName, const FMeshExportFileWriter* InWriter = nullptr, bool bInRecordMemory = false);
+	~FMeshExportStageTimer();
+
+	FMeshExportStageTimer(const FMeshExportStageTimer&) = delete;
+	FMeshExportStageTimer& operator=(const FMeshExportStageTimer&) = delete;
+
+	void AddBytes(int64 Bytes) { ExtraBytes += Bytes; }
+
+private:
+	FMeshExportReport* Report;
+	const TCHAR* Name;
+	const FMeshExportFileWriter* Writer;
+	bool bRecordMemory;
+	double StartTime;
+	int64 StartUsedPhysical = 0;
+	int64 StartBytes = 0;
+	int64 ExtraBytes = 0;
+};
+
+/** Times the rest of the scope as a stage of Report and as an Insights CPU event of the same name. Name must be a literal. */
+#define MESH_EXPORT_STAGE_SCOPE(Report, Name, ...) \
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR(Name); \
+	FMeshExportStageTimer PREPROCESSOR_JOIN(MeshExportStageTimer, __LINE__)(Report, Name, ##__VA_ARGS__)
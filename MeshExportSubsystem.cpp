@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MeshExportSubsystem.h"
+#include "MeshExportContext.h"
+
+void UMeshExportSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    Context = MakeShared<FMeshExportContext, ESPMode::ThreadSafe>();
+    FMeshExportContext::SetCurrent(Context);
+}
+
+void UMeshExportSubsystem::Deinitialize()
+{
+    // Exports still running keep their own reference, the buffers go once the last one finishes
+    FMeshExportContext::SetCurrent(nullptr);
+    Context.Reset();
+
+    Super::Deinitialize();
+}
+
+void UMeshExportSubsystem::ReleasePooledMemory()
+{
+    if (Context)
+    {
+        const int64 PooledBytes = Context->GetPooledBytes();
+        Context->Trim();
+        UE_LOG(LogTemp, Log, TEXT("Released %lld bytes of pooled export buffers"), PooledBytes);
+    }
+}
+
+int64 UMeshExportSubsystem::GetPooledBytes() const
+{
+    return Context ? Context->GetPooledBytes() : 0;
+}
+
+void UMeshExportSubsystem::SetMaxPooledMegabytes(int32 Megabytes)
+{
+    if (Context)
+    {
+        Context->SetMaxPooledBytes(static_cast<int64>(Megabytes) * 1024 * 1024);
+    }
+}
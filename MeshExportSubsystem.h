@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "MeshExportSubsystem.generated.h"
+
+class FMeshExportContext;
+
+/**
+ * Keeps the FMeshExportContext shared by every export for as long as the engine runs, so back-to-back exports
+ * from the same session reuse its module handle and buffers.
+ */
+UCLASS()
+class SAFRAN_APP_API UMeshExportSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Frees the buffers kept from earlier exports. */
+	UFUNCTION(BlueprintCallable, Category = "Mesh Export")
+	void ReleasePooledMemory();
+
+	/** Memory currently held for later exports, in bytes. */
+	UFUNCTION(BlueprintPure, Category = "Mesh Export")
+	int64 GetPooledBytes() const;
+
+	/** Limits the memory held for later exports; buffers beyond it are freed once an export is done with them. */
+	UFUNCTION(BlueprintCallable, Category = "Mesh Export")
+	void SetMaxPooledMegabytes(int32 Megabytes);
+
+private:
+	TSharedPtr<FMeshExportContext, ESPMode::ThreadSafe> Context;
+};
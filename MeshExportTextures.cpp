@@ -0,0 +1,794 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MeshExportTextures.h"
+#include "MeshExportPixelKernels.h"
+#include "MeshExportReport.h"
+#include "MeshExportTypes.h"
+#include "MeshExportWriter.h"
+#include "MeshExportContext.h"
+#include "Engine/Texture2D.h"
+#include "TextureResource.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Modules/ModuleManager.h"
+#include "Misc/FileHelper.h"
+#include "HAL/FileManager.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/PlatformTime.h"
+#include <atomic>
+
+#if WITH_EDITORONLY_DATA
+/**
+ * Resolves mip data in the given source format to 8-bit BGRA pixels.
+ * Data that is already BGRA8 is returned in place; anything else is converted into Scratch. Returns null for data that
+ * cannot be used.
+ */
+static const uint8* ResolveBGRA8(const uint8* RawData, int64 RawSize, int32 Width, int32 Height, ETextureSourceFormat Format, TArray64<uint8>& Scratch)
+{
+    const int64 NumPixels = static_cast<int64>(Width) * Height;
+    const int64 NumBytes = NumPixels * 4;
+
+    // Handle different source formats
+    switch (Format)
+    {
+    case TSF_BGRA8:
+    {
+        // Same layout as the image wrappers take, no copy needed
+        if (RawSize >= NumBytes)
+        {
+            return RawData;
+        }
+
+        // Short data: keep what is there and pad with black
+        Scratch.SetNumZeroed(NumBytes);
+        FMemory::Memcpy(Scratch.GetData(), RawData, RawSize & ~3ll);
+        return Scratch.GetData();
+    }
+    case TSF_G8:
+    {
+        // Grayscale to BGRA
+        if (RawSize < NumPixels)
+        {
+            return nullptr;
+        }
+        Scratch.SetNumUninitialized(NumBytes);
+        MeshExportPixels::ExpandGray8ToBGRA8(RawData, Scratch.GetData(), NumPixels);
+        return Scratch.GetData();
+    }
+    case TSF_G16:
+    {
+        if (RawSize < NumPixels * 2)
+        {
+            return nullptr;
+        }
+        Scratch.SetNumUninitialized(NumBytes);
+        MeshExportPixels::ExpandGray16ToBGRA8(reinterpret_cast<const uint16*>(RawData), Scratch.GetData(), NumPixels);
+        return Scratch.GetData();
+    }
+    case TSF_RGBA16:
+    {
+        if (RawSize < NumPixels * 8)
+        {
+            return nullptr;
+        }
+        Scratch.SetNumUninitialized(NumBytes);
+        MeshExportPixels::ConvertRGBA16ToBGRA8(reinterpret_cast<const uint16*>(RawData), Scratch.GetData(), NumPixels);
+        return Scratch.GetData();
+    }
+    default:
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Unsupported texture format: %d, trying raw copy"), (int32)Format);
+        // Try to interpret as BGRA anyway
+        return RawSize >= NumBytes ? RawData : nullptr;
+    }
+    }
+}
+#endif
+
+/**
+ * DXGI format of the texture's platform data if a DDS file can hold it as is, 0 otherwise, along with the size of its
+ * blocks in pixels and bytes. Game thread only.
+ */
+static uint32 GetDDSFormat(UTexture2D* Texture, int32& OutBlockSize, int32& OutBlockBytes)
+{
+    const FTexturePlatformData* PlatformData = Texture->GetPlatformData();
+    if (!PlatformData || PlatformData->Mips.Num() == 0)
+    {
+        return 0;
+    }
+
+    const bool bSRGB = Texture->SRGB;
+    OutBlockSize = 4;
+    OutBlockBytes = 16;
+    switch (PlatformData->PixelFormat)
+    {
+    case PF_DXT1:
+        OutBlockBytes = 8;
+        return bSRGB ? 72 : 71; // DXGI_FORMAT_BC1_UNORM(_SRGB)
+    case PF_DXT5:
+        return bSRGB ? 78 : 77; // DXGI_FORMAT_BC3_UNORM(_SRGB)
+    case PF_BC4:
+        OutBlockBytes = 8;
+        return 80; // DXGI_FORMAT_BC4_UNORM
+    case PF_BC5:
+        return 83; // DXGI_FORMAT_BC5_UNORM
+    case PF_BC7:
+        return bSRGB ? 99 : 98; // DXGI_FORMAT_BC7_UNORM(_SRGB)
+    case PF_B8G8R8A8:
+        OutBlockSize = 1;
+        OutBlockBytes = 4;
+        return bSRGB ? 91 : 87; // DXGI_FORMAT_B8G8R8A8_UNORM(_SRGB)
+    default:
+        return 0;
+    }
+}
+
+static constexpr uint32 MakeFourCC(ANSICHAR A, ANSICHAR B, ANSICHAR C, ANSICHAR D)
+{
+    return uint32(A) | (uint32(B) << 8) | (uint32(C) << 16) | (uint32(D) << 24);
+}
+
+/** Size in bytes of mip MipIndex of a Width x Height texture stored in blocks. */
+static int64 GetBlockMipSize(int32 Width, int32 Height, int32 MipIndex, int32 BlockSize, int32 BlockBytes)
+{
+    const int64 BlocksX = FMath::DivideAndRoundUp(FMath::Max(Width >> MipIndex, 1), BlockSize);
+    const int64 BlocksY = FMath::DivideAndRoundUp(FMath::Max(Height >> MipIndex, 1), BlockSize);
+    return BlocksX * BlocksY * BlockBytes;
+}
+
+/** First of NumMips mips of a Width x Height image whose larger side is at most MaxSize, or the last mip. */
+static int32 GetFirstMipToFit(int32 Width, int32 Height, int32 NumMips, int32 MaxSize)
+{
+    int32 MipIndex = 0;
+    if (MaxSize > 0)
+    {
+        while (MipIndex + 1 < NumMips && FMath::Max(Width >> MipIndex, Height >> MipIndex) > MaxSize)
+        {
+            MipIndex++;
+        }
+    }
+    return MipIndex;
+}
+
+/**
+ * Copies the mips of the job's platform data for SaveDDS, starting with the first whose larger side is at most MaxSize.
+ * Game thread only. Stops at the first mip that is not loaded or is shorter than its format needs; returns false,
+ * leaving the job as it was, if not even the first mip could be copied.
+ */
+static bool CopyPlatformMipsForDDS(FMeshExportTextureJob& Job, int32 MaxSize)
+{
+    int32 BlockSize = 1;
+    int32 BlockBytes = 4;
+    const uint32 DDSFormat = GetDDSFormat(Job.Texture, BlockSize, BlockBytes);
+    if (DDSFormat == 0)
+    {
+        return false;
+    }
+
+    FTexturePlatformData* PlatformData = Job.Texture->GetPlatformData();
+    const int32 Width = PlatformData->Mips[0].SizeX;
+    const int32 Height = PlatformData->Mips[0].SizeY;
+    const int32 FirstMip = GetFirstMipToFit(Width, Height, PlatformData->Mips.Num(), MaxSize);
+
+    TArray<TArray64<uint8>> Mips;
+    for (int32 MipIndex = FirstMip; MipIndex < PlatformData->Mips.Num(); MipIndex++)
+    {
+        FTexture2DMipMap& Mip = PlatformData->Mips[MipIndex];
+        const int64 MipSize = GetBlockMipSize(Width, Height, MipIndex, BlockSize, BlockBytes);
+        if (Mip.BulkData.GetBulkDataSize() < MipSize)
+        {
+            break;
+        }
+
+        const void* MipData = Mip.BulkData.LockReadOnly();
+        if (!MipData)
+        {
+            break;
+        }
+        Mips.Emplace(static_cast<const uint8*>(MipData), MipSize);
+        Mip.BulkData.Unlock();
+    }
+
+    if (Mips.Num() == 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Platform data of %s is not loaded, cannot write it as DDS"), *Job.Texture->GetName());
+        return false;
+    }
+
+    Job.PlatformMips = MoveTemp(Mips);
+    Job.PlatformWidth = FMath::Max(Width >> FirstMip, 1);
+    Job.PlatformHeight = FMath::Max(Height >> FirstMip, 1);
+    Job.DDSFormat = DDSFormat;
+    Job.BlockSize = BlockSize;
+    Job.BlockBytes = BlockBytes;
+    Job.bWriteDDS = true;
+    return true;
+}
+
+/**
+ * Halves Width x Height BGRA8 pixels until neither side is larger than MaxSize (0 for no limit). Returns Pixels
+ * itself if they already fit, otherwise the result, which is kept in Scratch; Pixels may point into Scratch.
+ * The intermediate buffer comes from Context's pool when there is one.
+ */
+static const uint8* ShrinkBGRA8ToFit(const uint8* Pixels, int32& Width, int32& Height, int32 MaxSize, TArray64<uint8>& Scratch, FMeshExportContext* Context)
+{
+    if (MaxSize <= 0 || FMath::Max(Width, Height) <= MaxSize)
+    {
+        return Pixels;
+    }
+
+    FMeshExportScopedPixelBuffer HalvedBuffer(Context, static_cast<int64>(FMath::Max(Width / 2, 1)) * FMath::Max(Height / 2, 1) * 4);
+    TArray64<uint8>& Halved = HalvedBuffer.Get();
+    while (FMath::Max(Width, Height) > MaxSize)
+    {
+        const int32 HalfWidth = FMath::Max(Width / 2, 1);
+        const int32 HalfHeight = FMath::Max(Height / 2, 1);
+
+        // Reset rather than SetNum so the capacity of the larger step is kept
+        Halved.Reset(static_cast<int64>(HalfWidth) * HalfHeight * 4);
+        Halved.AddUninitialized(static_cast<int64>(HalfWidth) * HalfHeight * 4);
+        MeshExportPixels::HalveBGRA8(Pixels, Width, Height, Halved.GetData());
+
+        // The previous pixels are no longer needed, their buffer is reused by the next step
+        Swap(Scratch, Halved);
+        Pixels = Scratch.GetData();
+        Width = HalfWidth;
+        Height = HalfHeight;
+    }
+    return Pixels;
+}
+
+FMeshExportTextureExporter::FMeshExportTextureExporter()
+{
+    check(IsInGameThread());
+
+    // The context of the subsystem already holds the module; exports outside of it load it themselves
+    Context = FMeshExportContext::Get();
+    ImageWrapperModule = Context
+        ? &Context->GetImageWrapperModule()
+        : &FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+
+    // Try TGA first (simpler, more compatible), then BMP (more widely supported)
+    OutputFormats = { EImageFormat::TGA, EImageFormat::BMP };
+}
+
+void FMeshExportTextureExporter::SetOutputFormats(TArrayView<const EImageFormat> Formats)
+{
+    check(Jobs.Num() == 0);
+    OutputFormats = TArray<EImageFormat>(Formats.GetData(), Formats.Num());
+}
+
+void FMeshExportTextureExporter::SetCompressedOutput(bool bEnable)
+{
+    check(Jobs.Num() == 0);
+    bCompressedOutput = bEnable;
+}
+
+void FMeshExportTextureExporter::Configure(const FMeshExportSettings& Settings, bool bForGLTF)
+{
+    EImageFormat Preferred = EImageFormat::TGA;
+    switch (Settings.TextureFormat)
+    {
+    case EMeshExportImageFormat::PNG:
+        Preferred = EImageFormat::PNG;
+        break;
+    case EMeshExportImageFormat::JPEG:
+        Preferred = EImageFormat::JPEG;
+        break;
+    case EMeshExportImageFormat::BMP:
+        Preferred = EImageFormat::BMP;
+        break;
+    default:
+        break;
+    }
+
+    if (bForGLTF)
+    {
+        if (Preferred == EImageFormat::JPEG)
+        {
+            SetOutputFormats({ EImageFormat::JPEG, EImageFormat::PNG });
+        }
+        else
+        {
+            SetOutputFormats({ EImageFormat::PNG, EImageFormat::JPEG });
+        }
+    }
+    else
+    {
+        // TGA and BMP are plain copies of the pixels, so they are kept as the last resort
+        TArray<EImageFormat> Formats = { Preferred };
+        Formats.AddUnique(EImageFormat::TGA);
+        Formats.AddUnique(EImageFormat::BMP);
+        SetOutputFormats(Formats);
+        SetCompressedOutput(Settings.bExportCompressedTextures);
+    }
+    JPEGQuality = FMath::Clamp(Settings.JPEGQuality, 1, 100);
+    MaxTextureSize = FMath::Max(Settings.MaxTextureSize, 0);
+}
+
+int32 FMeshExportTextureExporter::AddTexture(UTexture2D* Texture, const FString& BaseFileName, const FString& OutputDirectory)
+{
+    check(IsInGameThread());
+
+    // Materials sharing a texture share its job, so every file is written once and never by two threads
+    if (const int32* ExistingJob = TextureToJob.Find(Texture))
+    {
+        return *ExistingJob;
+    }
+
+    // Different texture objects can still carry the same source image (duplicated assets for instance).
+    // Cooked builds have no source data, only the platform data is left.
+#if WITH_EDITORONLY_DATA
+    const bool bHasSource = Texture->Source.IsValid();
+    const FGuid SourceId = bHasSource ? Texture->Source.GetId() : FGuid();
+#else
+    const bool bHasSource = false;
+    const FGuid SourceId;
+#endif
+    if (SourceId.IsValid())
+    {
+        if (const int32* ExistingJob = SourceIdToJob.Find(SourceId))
+        {
+            UE_LOG(LogTemp, Log, TEXT("Texture %s has the same source as %s, reusing it"),
+                *Texture->GetName(), *Jobs[*ExistingJob].Texture->GetName());
+            TextureToJob.Add(Texture, *ExistingJob);
+            return *ExistingJob;
+        }
+    }
+
+    // Check if this is a virtual texture
+    if (Texture->VirtualTextureStreaming)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Texture %s uses Virtual Texture Streaming - this may cause export issues. Consider disabling VT for this texture."), *Texture->GetName());
+    }
+
+    const int32 JobIndex = Jobs.AddDefaulted();
+    FMeshExportTextureJob& Job = Jobs[JobIndex];
+    Job.Texture = Texture;
+    Job.BaseFileName = BaseFileName;
+    Job.OutputDirectory = OutputDirectory;
+
+    // The built data is written as is when DDS can hold it, with or without source data
+    int32 BlockSize = 1;
+    int32 BlockBytes = 4;
+    const uint32 DDSFormat = bCompressedOutput ? GetDDSFormat(Texture, BlockSize, BlockBytes) : 0;
+
+    if (!bHasSource && DDSFormat == 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Texture source is invalid, will try alternative method"));
+        Job.bNeedsPlatformData = true;
+    }
+#if WITH_EDITORONLY_DATA
+    else if (SourceId.IsValid())
+    {
+        // The source GUID changes whenever the source image does, size and format guard against the rest.
+        // The output format is part of the key so an export in another format does not pick up these files.
+        Job.CacheKey = FString::Printf(TEXT("%s_%dx%d_%d_%d"), *SourceId.ToString(EGuidFormats::Digits),
+            Texture->Source.GetSizeX(), Texture->Source.GetSizeY(), (int32)Texture->Source.GetFormat(), (int32)OutputFormats[0]);
+        if (DDSFormat != 0)
+        {
+            Job.CacheKey += FString::Printf(TEXT("_dds%u"), DDSFormat);
+        }
+        else if (OutputFormats[0] == EImageFormat::JPEG)
+        {
+            Job.CacheKey += FString::Printf(TEXT("_q%d"), JPEGQuality);
+        }
+        if (MaxTextureSize > 0)
+        {
+            Job.CacheKey += FString::Printf(TEXT("_max%d"), MaxTextureSize);
+        }
+        SourceIdToJob.Add(SourceId, JobIndex);
+    }
+#endif
+
+    if (!CacheManifestPath.IsEmpty() && !Job.CacheKey.IsEmpty())
+    {
+        const FString* CachedFile = CachedFiles.Find(Job.BaseFileName);
+        const FString* CachedKey = CachedFile ? CachedKeys.Find(Job.BaseFileName) : nullptr;
+        if (CachedKey && *CachedKey == Job.CacheKey && IFileManager::Get().FileSize(*(OutputDirectory / *CachedFile)) > 0)
+        {
+            UE_LOG(LogTemp, Log, TEXT("Texture %s is unchanged since the last export, keeping %s"), *Texture->GetName(), **CachedFile);
+            Job.ExportedFileName = *CachedFile;
+            Job.bFromCache = true;
+            Job.bProcessed = true;
+        }
+    }
+
+    // Copied now since the platform data can only be read on the game thread
+    if (DDSFormat != 0 && !Job.bFromCache && !CopyPlatformMipsForDDS(Job, MaxTextureSize) && !bHasSource)
+    {
+        Job.bNeedsPlatformData = true;
+    }
+
+    TextureToJob.Add(Texture, JobIndex);
+    return JobIndex;
+}
+
+void FMeshExportTextureExporter::EnableDiskCache(const FString& Directory)
+{
+    CacheManifestPath = Directory / TEXT("TextureCache.txt");
+    CachedFiles.Reset();
+    CachedKeys.Reset();
+
+    // One "<base name> <cache key> <file name>" line per texture
+    TArray<FString> Lines;
+    if (FFileHelper::LoadFileToStringArray(Lines, *CacheManifestPath))
+    {
+        for (const FString& Line : Lines)
+        {
+            TArray<FString> Fields;
+            if (Line.ParseIntoArray(Fields, TEXT("\t")) == 3)
+            {
+                CachedKeys.Add(Fields[0], Fields[1]);
+                CachedFiles.Add(Fields[0], Fields[2]);
+            }
+        }
+        UE_LOG(LogTemp, Log, TEXT("Loaded %d cached texture entries from %s"), CachedFiles.Num(), *CacheManifestPath);
+    }
+}
+
+void FMeshExportTextureExporter::SaveDiskCache() const
+{
+    if (CacheManifestPath.IsEmpty())
+    {
+        return;
+    }
+
+    // Entries from earlier exports into the same folder are kept unless this export replaced them
+    TMap<FString, FString> Keys = CachedKeys;
+    TMap<FString, FString> Files = CachedFiles;
+    for (const FMeshExportTextureJob& Job : Jobs)
+    {
+        if (Job.CacheKey.IsEmpty() || Job.ExportedFileName.IsEmpty())
+        {
+            Keys.Remove(Job.BaseFileName);
+            Files.Remove(Job.BaseFileName);
+            continue;
+        }
+        Keys.Add(Job.BaseFileName, Job.CacheKey);
+        Files.Add(Job.BaseFileName, Job.ExportedFileName);
+    }
+
+    FString Manifest;
+    for (const TPair<FString, FString>& Entry : Files)
+    {
+        Manifest += FString::Printf(TEXT("%s\t%s\t%s\n"), *Entry.Key, *Keys[Entry.Key], *Entry.Value);
+    }
+
+    if (!FFileHelper::SaveStringToFile(Manifest, *CacheManifestPath))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Failed to save texture cache manifest: %s"), *CacheManifestPath);
+    }
+}
+
+void FMeshExportTextureExporter::ProcessJobs(int32 MaxConcurrency, const FMeshExportProgress* Progress)
+{
+    TArray<int32> PendingJobs;
+    for (int32 JobIndex = 0; JobIndex < Jobs.Num(); JobIndex++)
+    {
+        if (!Jobs[JobIndex].bProcessed && (!Jobs[JobIndex].bNeedsPlatformData || Jobs[JobIndex].bUsePlatformData))
+        {
+            PendingJobs.Add(JobIndex);
+        }
+    }
+
+    if (PendingJobs.Num() == 0)
+    {
+        return;
+    }
+
+    // A fixed number of workers pull jobs until none are left, which bounds how many full-size
+    // pixel buffers are alive at the same time
+    const int32 NumWorkers = FMath::Min(PendingJobs.Num(),
+        MaxConcurrency > 0 ? MaxConcurrency : FTaskGraphInterface::Get().GetNumWorkerThreads() + 1);
+
+    UE_LOG(LogTemp, Log, TEXT("Exporting %d textures on %d workers"), PendingJobs.Num(), NumWorkers);
+
+    std::atomic<int32> NextJob{0};
+    ParallelFor(NumWorkers, [this, &PendingJobs, &NextJob, Progress](int32 WorkerIndex)
+    {
+        for (int32 Pending = NextJob++; Pending < PendingJobs.Num(); Pending = NextJob++)
+        {
+            if (Progress && Progress->IsCancelled())
+            {
+                return;
+            }
+            ProcessJob(Jobs[PendingJobs[Pending]]);
+        }
+    });
+}
+
+void FMeshExportTextureExporter::AddToReport(FMeshExportReport& Report) const
+{
+    double DecodeSeconds = 0.0;
+    double EncodeSeconds = 0.0;
+    double WriteSeconds = 0.0;
+    int64 BytesWritten = 0;
+    int32 NumProcessed = 0;
+
+    for (const FMeshExportTextureJob& Job : Jobs)
+    {
+        FMeshExportTextureReport& Entry = Report.Textures.AddDefaulted_GetRef();
+        Entry.Name = Job.Texture ? Job.Texture->GetName() : Job.BaseFileName;
+        Entry.FileName = Job.ExportedFileName;
+        Entry.DecodeSeconds = Job.DecodeSeconds;
+        Entry.EncodeSeconds = Job.EncodeSeconds;
+        Entry.WriteSeconds = Job.WriteSeconds;
+        Entry.BytesWritten = Job.BytesWritten;
+        Entry.bFromCache = Job.bFromCache;
+
+        if (!Job.bFromCache)
+        {
+            DecodeSeconds += Job.DecodeSeconds;
+            EncodeSeconds += Job.EncodeSeconds;
+            WriteSeconds += Job.WriteSeconds;
+            BytesWritten += Job.BytesWritten;
+            NumProcessed++;
+        }
+    }
+
+    // Worker time rather than wall time: with several workers these add up to more than the textures stage
+    if (NumProcessed > 0)
+    {
+        Report.AddStage(TEXT("Texture decode"), DecodeSeconds, 0, NumProcessed);
+        Report.AddStage(TEXT("Texture encode"), EncodeSeconds, 0, NumProcessed);
+        Report.AddStage(TEXT("Texture write"), WriteSeconds, BytesWritten, NumProcessed);
+    }
+}
+
+bool FMeshExportTextureExporter::PreparePlatformDataFallbacks()
+{
+    check(IsInGameThread());
+
+    bool bAnyPrepared = false;
+    for (FMeshExportTextureJob& Job : Jobs)
+    {
+        if (!Job.bNeedsPlatformData || Job.bUsePlatformData || !Job.ExportedFileName.IsEmpty())
+        {
+            continue;
+        }
+
+        // Alternative method for Virtual Textures or when source is unavailable
+        UE_LOG(LogTemp, Log, TEXT("Trying to export %s using alternative method..."), *Job.Texture->GetName());
+        Job.bUsePlatformData = true;
+        Job.bProcessed = true;
+
+        // Try to read texture data from platform data
+        FTexturePlatformData* PlatformData = Job.Texture->GetPlatformData();
+        if (!PlatformData || PlatformData->Mips.Num() == 0)
+        {
+            UE_LOG(LogTemp, Error, TEXT("No platform data available"));
+            continue;
+        }
+
+        // Block compressed data cannot be handed to the image encoders, but DDS can hold it as is. Only where DDS output
+        // was asked for: glTF cannot reference DDS images, so the file would just be left unused
+        if (PlatformData->PixelFormat != PF_B8G8R8A8)
+        {
+            if (!bCompressedOutput)
+            {
+                UE_LOG(LogTemp, Error, TEXT("Platform data format %d cannot be exported without compressed texture output"), (int32)PlatformData->PixelFormat);
+            }
+            else if (CopyPlatformMipsForDDS(Job, MaxTextureSize))
+            {
+                UE_LOG(LogTemp, Log, TEXT("Got %d compressed platform mips: %dx%d, DXGI format %u"),
+                    Job.PlatformMips.Num(), Job.PlatformWidth, Job.PlatformHeight, Job.DDSFormat);
+                Job.bProcessed = false;
+                bAnyPrepared = true;
+            }
+            else
+            {
+                UE_LOG(LogTemp, Error, TEXT("Platform data format %d cannot be exported"), (int32)PlatformData->PixelFormat);
+            }
+            continue;
+        }
+
+        const int32 MipIndex = GetFirstMipToFit(PlatformData->Mips[0].SizeX, PlatformData->Mips[0].SizeY, PlatformData->Mips.Num(), MaxTextureSize);
+        FTexture2DMipMap& Mip = PlatformData->Mips[MipIndex];
+        const void* MipData = Mip.BulkData.LockReadOnly();
+        if (!MipData)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Failed to lock mip data"));
+            continue;
+        }
+
+        Job.PlatformWidth = Mip.SizeX;
+        Job.PlatformHeight = Mip.SizeY;
+        Job.PlatformMipData.Append(static_cast<const uint8*>(MipData), Mip.BulkData.GetBulkDataSize());
+        Mip.BulkData.Unlock();
+
+        UE_LOG(LogTemp, Log, TEXT("Got platform data: %dx%d, %lld bytes"),
+            Job.PlatformWidth, Job.PlatformHeight, Job.PlatformMipData.Num());
+
+        Job.bProcessed = false;
+        bAnyPrepared = true;
+    }
+    return bAnyPrepared;
+}
+
+void FMeshExportTextureExporter::ProcessJob(FMeshExportTextureJob& Job) const
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FMeshExportTextureExporter::ProcessJob);
+    Job.bProcessed = true;
+
+    if (Job.bWriteDDS)
+    {
+        SaveDDS(Job);
+        Job.PlatformMips.Empty();
+        return;
+    }
+
+    if (Job.bUsePlatformData)
+    {
+        // Only BGRA8 platform data gets here, which is handed to the encoder as is
+        if (Job.PlatformMipData.Num() < static_cast<int64>(Job.PlatformWidth) * Job.PlatformHeight * 4)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Platform data size mismatch"));
+        }
+        else
+        {
+            FMeshExportScopedPixelBuffer Shrunk(Context.Get(), 0);
+            int32 Width = Job.PlatformWidth;
+            int32 Height = Job.PlatformHeight;
+            const uint8* Pixels = ShrinkBGRA8ToFit(Job.PlatformMipData.GetData(), Width, Height, MaxTextureSize, Shrunk.Get(), Context.Get());
+            EncodeAndSave(Pixels, Width, Height, Job);
+        }
+        Job.PlatformMipData.Empty();
+        return;
+    }
+
+#if WITH_EDITORONLY_DATA
+    // Get texture source data. Passing the module in lets compressed sources decode off the game thread.
+    const double DecodeStart = FPlatformTime::Seconds();
+    FTextureSource& TextureSource = Job.Texture->Source;
+    const int32 MipIndex = GetFirstMipToFit(TextureSource.GetSizeX(), TextureSource.GetSizeY(), TextureSource.GetNumMips(), MaxTextureSize);
+    TArray64<uint8> RawData;
+    TextureSource.GetMipData(RawData, 0, 0, MipIndex, ImageWrapperModule);
+
+    if (RawData.Num() == 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Texture has no mip data, will try alternative method"));
+        Job.DecodeSeconds += FPlatformTime::Seconds() - DecodeStart;
+        Job.bNeedsPlatformData = true;
+        return;
+    }
+
+    int32 Width = FMath::Max(TextureSource.GetSizeX() >> MipIndex, 1);
+    int32 Height = FMath::Max(TextureSource.GetSizeY() >> MipIndex, 1);
+    ETextureSourceFormat Format = TextureSource.GetFormat();
+
+    UE_LOG(LogTemp, Log, TEXT("Texture %s size: %dx%d, Format: %d, Data size: %lld"),
+        *Job.Texture->GetName(), Width, Height, (int32)Format, RawData.Num());
+
+    // Either points into RawData itself or into Converted, which is taken from the pool
+    FMeshExportScopedPixelBuffer ConvertedBuffer(Context.Get(), Format == TSF_BGRA8 ? 0 : static_cast<int64>(Width) * Height * 4);
+    TArray64<uint8>& Converted = ConvertedBuffer.Get();
+    const uint8* Pixels = ResolveBGRA8(RawData.GetData(), RawData.Num(), Width, Height, Format, Converted);
+    if (!Pixels)
+    {
+        Job.DecodeSeconds += FPlatformTime::Seconds() - DecodeStart;
+        UE_LOG(LogTemp, Error, TEXT("Texture conversion failed"));
+        return;
+    }
+
+    // Only sources without a small enough mip get here larger than MaxTextureSize
+    Pixels = ShrinkBGRA8ToFit(Pixels, Width, Height, MaxTextureSize, Converted, Context.Get());
+    Job.DecodeSeconds += FPlatformTime::Seconds() - DecodeStart;
+
+    EncodeAndSave(Pixels, Width, Height, Job);
+#else
+    Job.bNeedsPlatformData = true;
+#endif
+}
+
+bool FMeshExportTextureExporter::EncodeAndSave(const uint8* Pixels, int32 Width, int32 Height, FMeshExportTextureJob& Job) const
+{
+    for (const EImageFormat Format : OutputFormats)
+    {
+        const double EncodeStart = FPlatformTime::Seconds();
+        TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule->CreateImageWrapper(Format);
+        if (!ImageWrapper.IsValid())
+        {
+            continue;
+        }
+
+        // Pixels are BGRA8, which every wrapper accepts (PNG and JPEG swizzle as needed)
+        if (!ImageWrapper->SetRaw(Pixels, static_cast<int64>(Width) * Height * 4, Width, Height, ERGBFormat::BGRA, 8))
+        {
+            continue;
+        }
+
+        // The quality only matters for JPEG, the other formats are lossless
+        const TArray64<uint8>& CompressedData = ImageWrapper->GetCompressed(Format == EImageFormat::JPEG ? JPEGQuality : 100);
+        Job.EncodeSeconds += FPlatformTime::Seconds() - EncodeStart;
+        if (CompressedData.Num() == 0)
+        {
+            continue;
+        }
+
+        const FString TextureName = Job.BaseFileName + TEXT(".") + ImageWrapperModule->GetExtension(Format);
+        const FString TexturePath = Job.OutputDirectory / TextureName;
+
+        // Written straight from the encoder's buffer, through a temporary file like the geometry
+        const double WriteStart = FPlatformTime::Seconds();
+        FMeshExportFileWriter Writer(0);
+        bool bSaved = Writer.Open(TexturePath);
+        if (bSaved)
+        {
+            Writer.Write(CompressedData.GetData(), CompressedData.Num());
+            bSaved = Writer.Close();
+        }
+        Job.WriteSeconds += FPlatformTime::Seconds() - WriteStart;
+        if (bSaved)
+        {
+            Job.BytesWritten = CompressedData.Num();
+            UE_LOG(LogTemp, Log, TEXT("Successfully exported texture: %s (%lld bytes)"), *TexturePath, CompressedData.Num());
+            Job.ExportedFileName = TextureName;
+            return true;
+        }
+
+        UE_LOG(LogTemp, Error, TEXT("Failed to save texture file: %s"), *TexturePath);
+    }
+
+    return false;
+}
+
+bool FMeshExportTextureExporter::SaveDDS(FMeshExportTextureJob& Job) const
+{
+    // "DDS " magic, DDS_HEADER and DDS_HEADER_DXT10. The DX10 header is always used since it is the only one that
+    // can say BC7 or sRGB.
+    constexpr uint32 DDSD_CAPS = 0x1, DDSD_HEIGHT = 0x2, DDSD_WIDTH = 0x4, DDSD_PITCH = 0x8, DDSD_PIXELFORMAT = 0x1000,
+        DDSD_MIPMAPCOUNT = 0x20000, DDSD_LINEARSIZE = 0x80000;
+    constexpr uint32 DDSCAPS_COMPLEX = 0x8, DDSCAPS_TEXTURE = 0x1000, DDSCAPS_MIPMAP = 0x400000;
+    constexpr uint32 DDPF_FOURCC = 0x4;
+
+    const int32 NumMips = Job.PlatformMips.Num();
+    const bool bBlockCompressed = Job.BlockSize > 1;
+
+    uint32 Header[37] = {};
+    Header[0] = MakeFourCC('D', 'D', 'S', ' ');
+    Header[1] = 124;
+    Header[2] = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | (bBlockCompressed ? DDSD_LINEARSIZE : DDSD_PITCH);
+    Header[3] = Job.PlatformHeight;
+    Header[4] = Job.PlatformWidth;
+    Header[5] = bBlockCompressed ? static_cast<uint32>(Job.PlatformMips[0].Num()) : Job.PlatformWidth * 4;
+    Header[7] = NumMips;
+    Header[19] = 32;
+    Header[20] = DDPF_FOURCC;
+    Header[21] = MakeFourCC('D', 'X', '1', '0');
+    Header[27] = DDSCAPS_TEXTURE | (NumMips > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0);
+    Header[32] = Job.DDSFormat;
+    Header[33] = 3; // D3D10_RESOURCE_DIMENSION_TEXTURE2D
+    Header[35] = 1; // Array size
+
+    const FString TextureName = Job.BaseFileName + TEXT(".dds");
+    const FString TexturePath = Job.OutputDirectory / TextureName;
+
+    // The mips go to the file straight from the copies, largest first as DDS stores them
+    const double WriteStart = FPlatformTime::Seconds();
+    FMeshExportFileWriter Writer(0);
+    bool bSaved = Writer.Open(TexturePath);
+    if (bSaved)
+    {
+        Writer.Write(Header, sizeof(Header));
+        for (const TArray64<uint8>& Mip : Job.PlatformMips)
+        {
+            Writer.Write(Mip.GetData(), Mip.Num());
+        }
+        Job.BytesWritten = Writer.GetBytesWritten();
+        bSaved = Writer.Close();
+    }
+    Job.WriteSeconds += FPlatformTime::Seconds() - WriteStart;
+
+    if (!bSaved)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to save texture file: %s"), *TexturePath);
+        Job.BytesWritten = 0;
+        return false;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Successfully exported texture: %s (%d mips, %lld bytes)"), *TexturePath, NumMips, Job.BytesWritten);
+    Job.ExportedFileName = TextureName;
+    return true;
+}
@@ -0,0 +1,171 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MeshExportMaterials.h"
+
+class IImageWrapperModule;
+class FMeshExportProgress;
+class FMeshExportContext;
+class UTexture2D;
+struct FMeshExportReport;
+struct FMeshExportSettings;
+enum class EImageFormat : int8;
+
+/** One texture to decode, convert, encode and write. Jobs are independent of each other. */
+struct FMeshExportTextureJob
+{
+	/** Texture being exported; kept alive by the materials of the mesh being exported. */
+	UTexture2D* Texture = nullptr;
+
+	/** Sanitized file name without extension, and the folder it is written to. */
+	FString BaseFileName;
+	FString OutputDirectory;
+
+	/**
+	 * Copy of mip 0 of BGRA8 platform data, used when the texture source could not be read.
+	 * PlatformWidth and PlatformHeight are also the size of mip 0 of PlatformMips.
+	 */
+	TArray64<uint8> PlatformMipData;
+	int32 PlatformWidth = 0;
+	int32 PlatformHeight = 0;
+	bool bUsePlatformData = false;
+
+	/**
+	 * Every mip of the platform data as the engine built it, from mip 0 down, written to a DDS file without decoding
+	 * when bWriteDDS is set. DDSFormat is the matching DXGI format; blocks are BlockSize pixels wide holding BlockBytes.
+	 */
+	TArray<TArray64<uint8>> PlatformMips;
+	uint32 DDSFormat = 0;
+	int32 BlockSize = 1;
+	int32 BlockBytes = 4;
+	bool bWriteDDS = false;
+
+	/** Identifies the texture contents for the on-disk cache; empty when the texture cannot be cached. */
+	FString CacheKey;
+
+	/** The file from a previous export is still valid and was reused as is. */
+	bool bFromCache = false;
+
+	/** Set once the job ran; bNeedsPlatformData asks for a second try from the platform data. */
+	bool bProcessed = false;
+	bool bNeedsPlatformData = false;
+
+	/** Name of the written file relative to OutputDirectory, empty if nothing was written. */
+	FString ExportedFileName;
+
+	/** Time spent reading and converting the pixels, encoding them and saving the file, summed over both tries. */
+	double DecodeSeconds = 0.0;
+	double EncodeSeconds = 0.0;
+	double WriteSeconds = 0.0;
+	int64 BytesWritten = 0;
+};
+
+/** Material written to the MTL file or the GLB, with the texture job providing each of its channels if any. */
+struct FMeshExportMaterialEntry
+{
+	FString MaterialName;
+	int32 TextureJobs[MeshExportNumMaterialChannels];
+
+	FMeshExportMaterialEntry()
+	{
+		for (int32& TextureJob : TextureJobs)
+		{
+			TextureJob = INDEX_NONE;
+		}
+	}
+
+	int32 GetTextureJob(EMeshExportMaterialChannel Channel) const { return TextureJobs[static_cast<int32>(Channel)]; }
+};
+
+/**
+ * Exports the textures used by a set of materials.
+ * Jobs are collected on the game thread, then run in parallel from any thread with a concurrency limit.
+ */
+class SAFRAN_APP_API FMeshExportTextureExporter
+{
+public:
+	/**
+	 * Takes the image wrapper module from the current FMeshExportContext, or loads it without one, so this has to be
+	 * constructed on the game thread. Conversion buffers come from the context's pool.
+	 */
+	FMeshExportTextureExporter();
+
+	/**
+	 * Sets the image formats to try, in order, when encoding a texture. The default is TGA then BMP.
+	 * Call before AddTexture, cached files written in another format are not reused.
+	 */
+	void SetOutputFormats(TArrayView<const EImageFormat> Formats);
+
+	/**
+	 * Writes textures whose platform data is BC1/BC3/BC4/BC5/BC7 or BGRA8 as DDS files with all of their mips, copied
+	 * from the built data instead of decoded and encoded again. Other textures still use the image formats.
+	 * Call before AddTexture.
+	 */
+	void SetCompressedOutput(bool bEnable);
+
+	/**
+	 * Sets the output formats, JPEG quality, size limit and compressed output from Settings, limited to the image formats glTF
+	 * allows when bForGLTF is set. Call before AddTexture.
+	 */
+	void Configure(const FMeshExportSettings& Settings, bool bForGLTF);
+
+	/**
+	 * Returns the job exporting Texture into OutputDirectory, adding it if needed. Game thread only.
+	 * Textures are matched by object and by source GUID, so each distinct image is processed and written once per export.
+	 */
+	int32 AddTexture(UTexture2D* Texture, const FString& BaseFileName, const FString& OutputDirectory);
+
+	/**
+	 * Loads the cache manifest kept in Directory. Textures added afterwards whose source is unchanged since the
+	 * previous export, and whose file is still there, are not processed again. Call before AddTexture.
+	 */
+	void EnableDiskCache(const FString& Directory);
+
+	bool IsDiskCacheEnabled() const { return !CacheManifestPath.IsEmpty(); }
+
+	/** Writes the cache manifest back with the results of this export. */
+	void SaveDiskCache() const;
+
+	/**
+	 * Runs every job that has not run yet, at most MaxConcurrency at a time (0 uses all workers). Once Progress is
+	 * cancelled no further job is started and the jobs not started are left for a later call.
+	 */
+	void ProcessJobs(int32 MaxConcurrency, const FMeshExportProgress* Progress = nullptr);
+
+	/**
+	 * Copies platform data for the jobs whose texture source could not be read. Game thread only.
+	 * Returns true if any job was reset and needs another ProcessJobs call.
+	 */
+	bool PreparePlatformDataFallbacks();
+
+	/** Adds the decode, encode and write times of every job to Report, as stages and as one entry per texture. */
+	void AddToReport(FMeshExportReport& Report) const;
+
+	int32 NumJobs() const { return Jobs.Num(); }
+	const FMeshExportTextureJob& GetJob(int32 Index) const { return Jobs[Index]; }
+
+private:
+	void ProcessJob(FMeshExportTextureJob& Job) const;
+	/** Encodes Width x Height BGRA8 pixels and writes the file in the first of OutputFormats that works. */
+	bool EncodeAndSave(const uint8* Pixels, int32 Width, int32 Height, FMeshExportTextureJob& Job) const;
+	/** Writes the copied platform mips of Job as a DDS file. */
+	bool SaveDDS(FMeshExportTextureJob& Job) const;
+
+	TSharedPtr<FMeshExportContext, ESPMode::ThreadSafe> Context;
+	IImageWrapperModule* ImageWrapperModule = nullptr;
+	TArray<EImageFormat> OutputFormats;
+	int32 JPEGQuality = 100;
+	/** Largest side of the written images, 0 for no limit. */
+	int32 MaxTextureSize = 0;
+	bool bCompressedOutput = false;
+	TArray<FMeshExportTextureJob> Jobs;
+	TMap<UTexture2D*, int32> TextureToJob;
+	TMap<FGuid, int32> SourceIdToJob;
+
+	/** Cache key and file name per texture base name from previous exports; empty path when the cache is off. */
+	FString CacheManifestPath;
+	TMap<FString, FString> CachedKeys;
+	TMap<FString, FString> CachedFiles;
+};
@@ -0,0 +1,297 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Misc/ScopeLock.h"
+#include "UObject/ObjectPtr.h"
+#include <atomic>
+#include "MeshExportTypes.generated.h"
+
+class AVolume;
+class UDataLayerAsset;
+
+/**
+ * Decides which actors are collected for export. Every test is applied to the static mesh component and its owner,
+ * so excluded geometry is never merged or read. The bounds tests are applied to every instance of an instanced
+ * component on its own. The defaults let everything through, each filter is opt-in.
+ */
+USTRUCT(BlueprintType)
+struct SAFRAN_APP_API FMeshExportFilter
+{
+	GENERATED_BODY()
+
+	/** Only export components whose bounds center lies inside Bounds. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Filter")
+	bool bUseBounds = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Filter", meta = (EditCondition = "bUseBounds"))
+	FBox Bounds = FBox(FVector(-100000.0), FVector(100000.0));
+
+	/** Only export components whose bounds center lies inside this volume, when set. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Filter")
+	TObjectPtr<AVolume> Volume = nullptr;
+
+	/** When not empty, only actors with at least one of these tags are exported. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Filter")
+	TArray<FName> IncludeTags;
+
+	/** Actors with any of these tags are never exported. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Filter")
+	TArray<FName> ExcludeTags;
+
+	/** When not empty, only actors in at least one of these data layers are exported. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Filter")
+	TArray<TObjectPtr<UDataLayerAsset>> DataLayers;
+
+	/** Skip actors hidden in game or in the editor, and components that are not visible. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Filter")
+	bool bSkipHidden = false;
+
+	/** Skip editor-only actors and components, such as placement helpers. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Filter")
+	bool bSkipEditorOnly = false;
+
+	/** Skip components whose bounding sphere is smaller than this radius, in Unreal units. 0 keeps everything. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Filter", meta = (ClampMin = "0"))
+	float MinBoundsRadius = 0.0f;
+
+	/** Skip components whose mesh has more triangles than this in the exported LOD. 0 keeps everything. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Filter", meta = (ClampMin = "0"))
+	int32 MaxTriangles = 0;
+};
+
+/** Image format textures are encoded to. TGA and BMP are uncompressed and the fastest to encode, PNG is lossless. */
+UENUM(BlueprintType)
+enum class EMeshExportImageFormat : uint8
+{
+	TGA,
+	PNG,
+	JPEG,
+	BMP
+};
+
+/** Options controlling how merged meshes are written to disk. */
+USTRUCT(BlueprintType)
+struct SAFRAN_APP_API FMeshExportSettings
+{
+	GENERATED_BODY()
+
+	/**
+	 * Merge every actor into one mesh before exporting it. When off, actors are written one after the other with their
+	 * world transforms and their own object names, without building a merged mesh or baking material atlases.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Source")
+	bool bMergeMeshes = true;
+
+	/** Which actors of the level are exported. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Source")
+	FMeshExportFilter Filter;
+
+	/**
+	 * Also export the instances of instanced static mesh components (ISM / HISM) of every actor, each as its own object.
+	 * Only used when bMergeMeshes is off; glTF output then references each mesh once from every instance.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Source")
+	bool bIncludeInstancedMeshes = true;
+
+	/**
+	 * Read the geometry from the render data vertex and index buffers instead of the mesh description. Faster, and the
+	 * only option in cooked builds, where the mesh has to allow CPU access for its buffers to be readable.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Source")
+	bool bExportFromRenderData = false;
+
+	/**
+	 * LOD exported, clamped to the LODs each mesh has. LODs generated by reduction have no mesh description and are read
+	 * from the render data. When merging, only this LOD of every component is merged.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Source", meta = (ClampMin = "0"))
+	int32 LODIndex = 0;
+
+	/**
+	 * When above 0, the export is simplified to about this many triangles in total, every mesh keeping the same
+	 * fraction of its triangles. Mesh descriptions are reduced with the editor's mesh reduction; render data
+	 * exports pick coarser LODs instead. Source assets are never modified.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Source", meta = (ClampMin = "0"))
+	int32 TargetTriangleCount = 0;
+
+	/**
+	 * When above 0, splits the world into square cells of this size (in Unreal units, on the XY plane) and exports each
+	 * cell to its own "<file>_X<x>_Y<y>" file, listed with its bounds in "<file>_tiles.json". Actors go to the cell
+	 * holding the center of their bounds. Tiles are exported one after the other, so memory use follows the largest tile.
+	 * Only used by MergeAndExportMeshes; tiles sharing textures re-export them unless bUseTextureCache is set.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Source", meta = (ClampMin = "0"))
+	float TileSize = 0.0f;
+
+	/**
+	 * When above 0 and bMergeMeshes is set, actors are merged in batches of about this many source triangles instead of
+	 * all at once, each batch written to its own "<file>_batch<n>" file. Actors are ordered by material set and then by
+	 * position, so a batch holds nearby actors sharing materials. Each batch's merged mesh, materials and atlas textures
+	 * are garbage collected before the next batch is merged, so memory use follows the batch size.
+	 * TargetTriangleCount applies to each batch. Only used by MergeAndExportMeshes without tiles.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Source", meta = (ClampMin = "0"))
+	int32 MaxTrianglesPerMergeBatch = 0;
+
+	/** Number of digits written after the decimal point for positions, normals and UVs. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|OBJ", meta = (ClampMin = "0", ClampMax = "9"))
+	int32 FloatPrecision = 6;
+
+	/** Drop trailing zeros from written floats ("0.500000" becomes "0.5"). Smaller files, same values. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|OBJ")
+	bool bTrimTrailingZeros = false;
+
+	/**
+	 * Write each distinct UV and normal once and give faces separate vt/vn indices.
+	 * Values are compared at FloatPrecision, so the output describes exactly the same mesh.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|OBJ")
+	bool bDeduplicateAttributes = false;
+
+	/**
+	 * Keep every exported object in a "<file>_GeometryCache" folder next to the OBJ, keyed by its mesh, materials, transform
+	 * and name, and copy unchanged objects from there on the next export instead of reading and formatting them again.
+	 * Only used when bMergeMeshes is off; GLB files reference shared meshes and are always written in full.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|OBJ")
+	bool bUseGeometryCache = false;
+
+	/**
+	 * Reorder triangles for the GPU vertex cache and vertices in the order triangles use them, in both OBJ and GLB
+	 * output. Costs a linear pass per mesh; the geometry itself is unchanged.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Performance")
+	bool bOptimizeVertexOrder = false;
+
+	/** Format vertex, UV, normal and face lines on worker threads. The file is byte-for-byte the same as a serial export. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Performance")
+	bool bParallelSerialization = true;
+
+	/** Maximum number of textures decoded, encoded and written at the same time. 0 uses every worker thread. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Performance", meta = (ClampMin = "0"))
+	int32 MaxConcurrentTextureJobs = 4;
+
+	/**
+	 * Save the time, output size and peak memory of every export stage next to the exported file as <name>_report.json.
+	 * The same figures are always logged and kept in the exporter's LastExportReport.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Performance")
+	bool bWriteExportReport = false;
+
+	/**
+	 * Keep a manifest of exported textures and their source hash in the Textures folder and skip textures
+	 * that have not changed since the previous export to the same place.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Textures")
+	bool bUseTextureCache = false;
+
+	/**
+	 * Format OBJ textures are written in; TGA then BMP are tried if it fails. glTF only allows PNG and JPEG, so glTF
+	 * exports use JPEG when it is chosen here and PNG otherwise.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Textures")
+	EMeshExportImageFormat TextureFormat = EMeshExportImageFormat::TGA;
+
+	/** Quality of JPEG textures; lower values give smaller files for previews. The other formats are lossless. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Textures", meta = (ClampMin = "1", ClampMax = "100"))
+	int32 JPEGQuality = 90;
+
+	/**
+	 * Largest width or height of exported textures, 0 keeps full resolution. The first source or platform mip that
+	 * fits is used, and images without a small enough mip are halved with a box filter until they fit.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Textures", meta = (ClampMin = "0"))
+	int32 MaxTextureSize = 0;
+
+	/**
+	 * Also export the normal, roughness, metallic, occlusion and emissive textures of the materials, written as the
+	 * MTL PBR extension maps and as the matching glTF material textures. When off only base color is exported.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Textures")
+	bool bExportPBRTextures = false;
+
+	/**
+	 * Write OBJ textures as DDS files holding every mip of the engine's built, usually BC compressed, data as is
+	 * instead of decoding and encoding them again. Textures in other formats are still written as images.
+	 * glTF exports ignore this since glTF only allows PNG and JPEG.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|Textures")
+	bool bExportCompressedTextures = false;
+
+	/**
+	 * Store the textures inside the GLB file; the image files are then deleted once the GLB is written, unless the
+	 * texture cache keeps them. When off, the GLB references the image files in the Textures folder.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|glTF")
+	bool bEmbedTextures = true;
+
+	/**
+	 * Store GLB vertex streams as integers (KHR_mesh_quantization), about half the size of float streams. Positions
+	 * become 16-bit integers scaled back by the node matrix, normals and UVs normalized integers. Meshes with UVs
+	 * outside 0-1 keep float UVs.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|glTF")
+	bool bQuantizeGeometry = false;
+
+	/** Bits kept per quantized position component. The largest error is about the mesh size divided by 2^Bits. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|glTF", meta = (ClampMin = "8", ClampMax = "16", EditCondition = "bQuantizeGeometry"))
+	int32 PositionQuantizationBits = 14;
+
+	/** Bits kept per quantized normal component; 8 or fewer are stored as bytes, more as shorts. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|glTF", meta = (ClampMin = "4", ClampMax = "16", EditCondition = "bQuantizeGeometry"))
+	int32 NormalQuantizationBits = 8;
+
+	/** Bits kept per quantized UV component. The largest error is 1 / 2^(Bits + 1) of the texture. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Export|glTF", meta = (ClampMin = "8", ClampMax = "16", EditCondition = "bQuantizeGeometry"))
+	int32 UVQuantizationBits = 12;
+};
+
+/**
+ * Progress and cancellation state shared between an export running in the background and whoever started it.
+ * Stages are begun on the game thread; the progress within a stage and the cancel flag can be touched from any thread.
+ */
+class SAFRAN_APP_API FMeshExportProgress
+{
+public:
+	/** Starts a named stage covering [StartFraction, EndFraction] of the whole export. */
+	void BeginStage(const FString& InStageName, float InStartFraction, float InEndFraction)
+	{
+		{
+			FScopeLock Lock(&StageLock);
+			StageName = InStageName;
+		}
+		StageStart = InStartFraction;
+		StageEnd = InEndFraction;
+		Fraction = InStartFraction;
+	}
+
+	/** Reports how far the current stage has got, from 0 to 1. */
+	void SetStageProgress(float StageFraction)
+	{
+		const float Start = StageStart;
+		Fraction = Start + (StageEnd - Start) * FMath::Clamp(StageFraction, 0.0f, 1.0f);
+	}
+
+	float GetProgress() const { return Fraction; }
+
+	FString GetStageName() const
+	{
+		FScopeLock Lock(&StageLock);
+		return StageName;
+	}
+
+	void Cancel() { bCancelled = true; }
+	bool IsCancelled() const { return bCancelled; }
+
+private:
+	mutable FCriticalSection StageLock;
+	FString StageName;
+	std::atomic<float> StageStart{0.0f};
+	std::atomic<float> StageEnd{1.0f};
+	std::atomic<float> Fraction{0.0f};
+	std::atomic<bool> bCancelled{false};
+};
@@ -0,0 +1,446 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MeshExportWriter.h"
+#include "MeshExportTypes.h"
+#include "MeshExportContext.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Serialization/Archive.h"
+#include "Containers/StringConv.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Misc/Paths.h"
+
+#if PLATFORM_WINDOWS
+#include "Windows/WindowsHWrapper.h"
+#endif
+
+namespace MeshExportFormat
+{
+    static constexpr uint64 PowersOf10[MaxFloatPrecision + 1] =
+    {
+        1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull, 1000000000ull
+    };
+
+    static constexpr ANSICHAR DigitPairs[201] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+    // Writes Value with exactly MinDigits digits if it is shorter (zero padded), more if needed
+    static ANSICHAR* WriteUnsigned(ANSICHAR* Dest, uint64 Value, int32 MinDigits = 1)
+    {
+        ANSICHAR Temp[24];
+        ANSICHAR* End = Temp + UE_ARRAY_COUNT(Temp);
+        ANSICHAR* Cursor = End;
+
+        while (Value >= 100)
+        {
+            const uint32 Pair = static_cast<uint32>(Value % 100) * 2;
+            Value /= 100;
+            *--Cursor = DigitPairs[Pair + 1];
+            *--Cursor = DigitPairs[Pair];
+        }
+        if (Value >= 10)
+        {
+            const uint32 Pair = static_cast<uint32>(Value) * 2;
+            *--Cursor = DigitPairs[Pair + 1];
+            *--Cursor = DigitPairs[Pair];
+        }
+        else
+        {
+            *--Cursor = static_cast<ANSICHAR>('0' + Value);
+        }
+
+        while (End - Cursor < MinDigits)
+        {
+            *--Cursor = '0';
+        }
+
+        const int32 Len = static_cast<int32>(End - Cursor);
+        FMemory::Memcpy(Dest, Cursor, Len);
+        return Dest + Len;
+    }
+
+    ANSICHAR* WriteInt(ANSICHAR* Dest, int64 Value)
+    {
+        if (Value < 0)
+        {
+            *Dest++ = '-';
+            return WriteUnsigned(Dest, 0ull - static_cast<uint64>(Value));
+        }
+        return WriteUnsigned(Dest, static_cast<uint64>(Value));
+    }
+
+    // |Value| * 10^Precision rounded half to even like printf does for exact ties, false when out of the exact integer range
+    static bool ToFixed(float Value, int32 Precision, uint64& OutFixed)
+    {
+        const double Scaled = FMath::Abs(static_cast<double>(Value)) * static_cast<double>(PowersOf10[Precision]);
+        if (!(Scaled < 1.0e17))
+        {
+            return false;
+        }
+
+        OutFixed = static_cast<uint64>(Scaled);
+        const double Remainder = Scaled - static_cast<double>(OutFixed);
+        if (Remainder > 0.5 || (Remainder == 0.5 && (OutFixed & 1) != 0))
+        {
+            ++OutFixed;
+        }
+        return true;
+    }
+
+    bool QuantizeFloat(float Value, int32 Precision, int64& OutFixed)
+    {
+        uint64 Fixed = 0;
+        if (!ToFixed(Value, FMath::Clamp(Precision, 0, MaxFloatPrecision), Fixed))
+        {
+            return false;
+        }
+
+        // Small negative values print without a sign, like zero
+        OutFixed = Value < 0.0f ? -static_cast<int64>(Fixed) : static_cast<int64>(Fixed);
+        return true;
+    }
+
+    ANSICHAR* WriteFloat(ANSICHAR* Dest, float Value, int32 Precision, bool bTrimTrailingZeros)
+    {
+        Precision = FMath::Clamp(Precision, 0, MaxFloatPrecision);
+
+        // Out of the exact integer range (or NaN/Inf): leave it to the CRT, this is rare for mesh data
+        uint64 Fixed = 0;
+        if (!ToFixed(Value, Precision, Fixed))
+        {
+            const int32 Len = FCStringAnsi::Snprintf(Dest, MaxFloatChars, "%.*f", Precision, static_cast<double>(Value));
+            return Dest + FMath::Clamp(Len, 0, MaxFloatChars - 1);
+        }
+
+        if (Value < 0.0f && Fixed != 0)
+        {
+            *Dest++ = '-';
+        }
+
+        Dest = WriteUnsigned(Dest, Fixed / PowersOf10[Precision]);
+        if (Precision == 0)
+        {
+            return Dest;
+        }
+
+        ANSICHAR* Point = Dest;
+        *Dest++ = '.';
+        Dest = WriteUnsigned(Dest, Fixed % PowersOf10[Precision], Precision);
+
+        if (bTrimTrailingZeros)
+        {
+            while (Dest[-1] == '0')
+            {
+                --Dest;
+            }
+            if (Dest - 1 == Point)
+            {
+                --Dest;
+            }
+        }
+        return Dest;
+    }
+}
+
+void FMeshExportTextBuffer::Reserve(int32 NumChars)
+{
+    if (NumChars > Data.Num())
+    {
+        // Grow geometrically, the buffer is reused so this settles quickly
+        Data.SetNumUninitialized(FMath::Max(NumChars, Data.Num() * 2));
+    }
+}
+
+void FMeshExportTextBuffer::Append(const ANSICHAR* Text, int32 Len)
+{
+    if (Len > 0)
+    {
+        FMemory::Memcpy(Grow(Len), Text, Len);
+        Length += Len;
+    }
+}
+
+void FMeshExportTextBuffer::Append(FStringView Text)
+{
+    if (Text.Len() > 0)
+    {
+        FTCHARToUTF8 Converted(Text.GetData(), Text.Len());
+        Append(reinterpret_cast<const ANSICHAR*>(Converted.Get()), Converted.Length());
+    }
+}
+
+FMeshExportFileWriter::FMeshExportFileWriter(int32 InBufferSize)
+    : BufferSize(FMath::Max(InBufferSize, 4096))
+{
+}
+
+FMeshExportFileWriter::~FMeshExportFileWriter()
+{
+    // Only an explicit Close commits the file, so an early return or an exception never leaves a partial one behind
+    Discard();
+}
+
+bool FMeshExportFileWriter::Open(const FString& InFilePath)
+{
+    Discard();
+
+    // Next to the target, so the final move is a rename on the same volume
+    FilePath = InFilePath;
+    File.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*GetTempPath()));
+    if (!File)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to open file for writing: %s"), *GetTempPath());
+        return false;
+    }
+
+    Buffer.Reset(BufferSize);
+    BytesWritten = 0;
+    ElementsDone = 0;
+    bError = false;
+    bCancelled = false;
+    return true;
+}
+
+/**
+ * Moves From over To in one step, so To is either the old or the new file even if the process dies halfway.
+ * IFileManager::Move deletes the target before renaming, which leaves nothing behind in between.
+ */
+static bool ReplaceFileAtomically(const FString& To, const FString& From)
+{
+    const FString FullTo = FPaths::ConvertRelativePathToFull(To);
+    const FString FullFrom = FPaths::ConvertRelativePathToFull(From);
+#if PLATFORM_WINDOWS
+    return ::MoveFileExW(*FullFrom, *FullTo, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    // rename() replaces an existing target atomically on POSIX file systems
+    return FPlatformFileManager::Get().GetPlatformFile().MoveFile(*FullTo, *FullFrom);
+#endif
+}
+
+bool FMeshExportFileWriter::Close()
+{
+    if (!File)
+    {
+        return !bError;
+    }
+
+    EndCapture(false);
+
+    Flush();
+    bError |= !File->Flush();
+    File.Reset();
+
+    const FString TempPath = GetTempPath();
+    if (bError || bCancelled)
+    {
+        IFileManager::Get().Delete(*TempPath);
+    }
+    else if (!ReplaceFileAtomically(FilePath, TempPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to move %s into place"), *TempPath);
+        IFileManager::Get().Delete(*TempPath);
+        bError = true;
+    }
+
+    // Give the memory back, the writer is usually kept around until the export finishes
+    Buffer.Empty();
+    ReleaseChunkBuffers();
+    return !bError;
+}
+
+void FMeshExportFileWriter::Discard()
+{
+    if (!File)
+    {
+        return;
+    }
+
+    EndCapture(false);
+    File.Reset();
+    IFileManager::Get().Delete(*GetTempPath());
+
+    Buffer.Empty();
+    ReleaseChunkBuffers();
+}
+
+void FMeshExportFileWriter::ReleaseChunkBuffers()
+{
+    if (Context)
+    {
+        for (FMeshExportTextBuffer& Text : ChunkBuffers)
+        {
+            Context->ReleaseTextBuffer(MoveTemp(Text));
+        }
+    }
+    ChunkBuffers.Empty();
+}
+
+void FMeshExportFileWriter::Write(const void* Data, int64 Num)
+{
+    if (!File || Num <= 0)
+    {
+        return;
+    }
+
+    const uint8* Bytes = static_cast<const uint8*>(Data);
+
+    // The capture file has its own archive buffer, so it is written straight away
+    if (CaptureArchive)
+    {
+        CaptureArchive->Serialize(const_cast<uint8*>(Bytes), Num);
+    }
+
+    // Large payloads skip the buffer entirely
+    if (Num >= BufferSize)
+    {
+        Flush();
+        bError |= !File->Write(Bytes, Num);
+        BytesWritten += Num;
+        return;
+    }
+
+    if (Buffer.Num() + Num > BufferSize)
+    {
+        Flush();
+    }
+
+    Buffer.Append(Bytes, static_cast<int32>(Num));
+    BytesWritten += Num;
+}
+
+void FMeshExportFileWriter::Write(FStringView Text)
+{
+    if (Text.Len() == 0)
+    {
+        return;
+    }
+
+    FTCHARToUTF8 Converted(Text.GetData(), Text.Len());
+    Write(static_cast<const void*>(Converted.Get()), Converted.Length());
+}
+
+bool FMeshExportFileWriter::BeginCapture(const FString& InCapturePath)
+{
+    EndCapture(false);
+
+    CapturePath = InCapturePath;
+    CaptureArchive.Reset(IFileManager::Get().CreateFileWriter(*(CapturePath + TEXT(".tmp"))));
+    if (!CaptureArchive)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Failed to open capture file: %s"), *CapturePath);
+        return false;
+    }
+    return true;
+}
+
+bool FMeshExportFileWriter::EndCapture(bool bKeep)
+{
+    if (!CaptureArchive)
+    {
+        return false;
+    }
+
+    const bool bCaptureOk = CaptureArchive->Close() && !CaptureArchive->IsError();
+    CaptureArchive.Reset();
+
+    const FString TempPath = CapturePath + TEXT(".tmp");
+    const bool bKept = bKeep && bCaptureOk && !bError && ReplaceFileAtomically(CapturePath, TempPath);
+    if (!bKept)
+    {
+        IFileManager::Get().Delete(*TempPath);
+    }
+    return bKept;
+}
+
+void FMeshExportFileWriter::SetProgress(FMeshExportProgress* InProgress, int64 InTotalElements)
+{
+    Progress = InProgress;
+    TotalElements = InTotalElements;
+    ElementsDone = 0;
+}
+
+bool FMeshExportFileWriter::WriteChunked(int32 NumElements, TFunctionRef<void(FMeshExportTextBuffer& Text, int32 Begin, int32 End)> FormatRange, bool bParallel)
+{
+    if (!File || bCancelled)
+    {
+        return !bCancelled;
+    }
+    if (NumElements <= 0)
+    {
+        return true;
+    }
+
+    const int32 NumChunks = FMath::DivideAndRoundUp(NumElements, ElementsPerChunk);
+
+    // Chunks are formatted one batch at a time so only a couple of chunks per worker are held in
+    // memory, however large the section is
+    const int32 ChunksPerBatch = bParallel
+        ? FMath::Min(NumChunks, (FTaskGraphInterface::Get().GetNumWorkerThreads() + 1) * 2)
+        : 1;
+    if (ChunkBuffers.Num() < ChunksPerBatch)
+    {
+        // Chunk buffers settle at the size of a chunk's text, so ones from an earlier export rarely grow again
+        if (!Context)
+        {
+            Context = FMeshExportContext::Get();
+        }
+        ChunkBuffers.Reserve(ChunksPerBatch);
+        while (ChunkBuffers.Num() < ChunksPerBatch)
+        {
+            ChunkBuffers.Add(Context ? Context->AcquireTextBuffer() : FMeshExportTextBuffer());
+        }
+    }
+
+    for (int32 BatchStart = 0; BatchStart < NumChunks; BatchStart += ChunksPerBatch)
+    {
+        if (Progress && Progress->IsCancelled())
+        {
+            bCancelled = true;
+            return false;
+        }
+
+        const int32 BatchCount = FMath::Min(ChunksPerBatch, NumChunks - BatchStart);
+
+        ParallelFor(BatchCount, [this, &FormatRange, BatchStart, NumElements](int32 LocalChunk)
+        {
+            FMeshExportTextBuffer& Text = ChunkBuffers[LocalChunk];
+            Text.Reset();
+
+            const int32 Begin = (BatchStart + LocalChunk) * ElementsPerChunk;
+            const int32 End = FMath::Min(Begin + ElementsPerChunk, NumElements);
+            FormatRange(Text, Begin, End);
+        }, bParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+
+        // Concatenate in chunk order so the file is identical to a serial run
+        for (int32 LocalChunk = 0; LocalChunk < BatchCount; ++LocalChunk)
+        {
+            Write(ChunkBuffers[LocalChunk]);
+        }
+
+        if (Progress && TotalElements > 0)
+        {
+            ElementsDone += FMath::Min(BatchCount * ElementsPerChunk, NumElements - BatchStart * ElementsPerChunk);
+            Progress->SetStageProgress(static_cast<float>(static_cast<double>(ElementsDone) / TotalElements));
+        }
+    }
+    return true;
+}
+
+void FMeshExportFileWriter::Flush()
+{
+    if (File && Buffer.Num() > 0)
+    {
+        bError |= !File->Write(Buffer.GetData(), Buffer.Num());
+    }
+    Buffer.Reset();
+}
@@ -0,0 +1,183 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FArchive;
+class IFileHandle;
+class FMeshExportProgress;
+class FMeshExportContext;
+
+/**
+ * Allocation-free number to ASCII conversion used for the text formats.
+ * Each function writes into Dest (which must have room for the Max*Chars constant) and returns
+ * the position just past the last written character. No terminator is written.
+ */
+namespace MeshExportFormat
+{
+	constexpr int32 MaxIntChars = 21;
+	constexpr int32 MaxFloatChars = 64;
+	constexpr int32 MaxFloatPrecision = 9;
+
+	SAFRAN_APP_API ANSICHAR* WriteInt(ANSICHAR* Dest, int64 Value);
+
+	/** Fixed-point output equivalent to "%.<Precision>f", optionally with trailing zeros removed. */
+	SAFRAN_APP_API ANSICHAR* WriteFloat(ANSICHAR* Dest, float Value, int32 Precision, bool bTrimTrailingZeros = false);
+
+	/**
+	 * The digits WriteFloat prints for Value, as Value * 10^Precision rounded the same way, so two values print alike
+	 * exactly when they quantize alike. Returns false for the values WriteFloat leaves to the CRT (huge, NaN or Inf).
+	 */
+	SAFRAN_APP_API bool QuantizeFloat(float Value, int32 Precision, int64& OutFixed);
+}
+
+/**
+ * Growable ASCII buffer that lines of text are formatted into before they are handed to a writer.
+ * Reset() keeps the allocation so the same buffer can be reused for the whole export.
+ */
+class SAFRAN_APP_API FMeshExportTextBuffer
+{
+public:
+	void Reset() { Length = 0; }
+	void Reserve(int32 NumChars);
+
+	int32 Num() const { return Length; }
+	int32 GetCapacity() const { return Data.Num(); }
+	const ANSICHAR* GetData() const { return Data.GetData(); }
+
+	void AppendChar(ANSICHAR Char) { *Grow(1) = Char; ++Length; }
+	void Append(const ANSICHAR* Text, int32 Len);
+	void Append(FStringView Text);
+
+	template <int32 N>
+	void Append(const ANSICHAR (&Literal)[N]) { Append(Literal, N - 1); }
+
+	/** Appends raw bytes, for binary formats that reuse the chunked writing path. */
+	void AppendBinary(const void* Bytes, int32 Num) { Append(static_cast<const ANSICHAR*>(Bytes), Num); }
+
+	void AppendInt(int64 Value)
+	{
+		ANSICHAR* Dest = Grow(MeshExportFormat::MaxIntChars);
+		Length += static_cast<int32>(MeshExportFormat::WriteInt(Dest, Value) - Dest);
+	}
+
+	void AppendFloat(float Value, int32 Precision, bool bTrimTrailingZeros = false)
+	{
+		ANSICHAR* Dest = Grow(MeshExportFormat::MaxFloatChars);
+		Length += static_cast<int32>(MeshExportFormat::WriteFloat(Dest, Value, Precision, bTrimTrailingZeros) - Dest);
+	}
+
+private:
+	/** Makes room for NumChars more characters and returns where they go. */
+	ANSICHAR* Grow(int32 NumChars)
+	{
+		if (Length + NumChars > Data.Num())
+		{
+			Reserve(Length + NumChars);
+		}
+		return Data.GetData() + Length;
+	}
+
+	/** Storage; Num() of this array is the capacity, Length is what is in use. */
+	TArray<ANSICHAR> Data;
+	int32 Length = 0;
+};
+
+/**
+ * Buffered UTF-8 file writer used by the mesh exporters.
+ * Output is collected in a fixed-size buffer and pushed to the file handle whenever it fills up,
+ * so memory use stays the same no matter how large the exported file gets. Writes of at least a buffer's size go
+ * to the file straight from the caller's memory.
+ * Everything goes to a temporary file next to the target, which only replaces the target once Close succeeds, so a
+ * failed, cancelled or killed export never leaves a half-written file behind. A writer destroyed or reopened without a
+ * Close discards its temporary file.
+ * The chunk buffers of WriteChunked are borrowed from the current FMeshExportContext, if any, and handed back on Close.
+ */
+class SAFRAN_APP_API FMeshExportFileWriter
+{
+public:
+	static constexpr int32 DefaultBufferSize = 1024 * 1024;
+
+	explicit FMeshExportFileWriter(int32 InBufferSize = DefaultBufferSize);
+	~FMeshExportFileWriter();
+
+	FMeshExportFileWriter(const FMeshExportFileWriter&) = delete;
+	FMeshExportFileWriter& operator=(const FMeshExportFileWriter&) = delete;
+
+	/** Creates the temporary file for FilePath. Returns false if it could not be opened for writing. */
+	bool Open(const FString& InFilePath);
+
+	/**
+	 * Flushes any pending data, closes the file and moves it over FilePath. After a failed write or a cancellation the
+	 * temporary file is deleted instead and FilePath is left as it was. Returns false if a write or the move failed.
+	 */
+	bool Close();
+
+	/** Closes and deletes the temporary file without touching FilePath. */
+	void Discard();
+
+	bool IsOpen() const { return File.IsValid(); }
+	bool HasError() const { return bError; }
+	bool WasCancelled() const { return bCancelled; }
+	int64 GetBytesWritten() const { return BytesWritten; }
+
+	/** Writes raw bytes. */
+	void Write(const void* Data, int64 Num);
+
+	/** Writes ASCII/UTF-8 text as is. */
+	void Write(const ANSICHAR* Text, int32 Len) { Write(static_cast<const void*>(Text), Len); }
+
+	/** Writes TCHAR text converted to UTF-8. */
+	void Write(FStringView Text);
+
+	/** Writes the formatted contents of a text buffer. */
+	void Write(const FMeshExportTextBuffer& Text) { Write(Text.GetData(), Text.Num()); }
+
+	/** Number of elements formatted together by WriteChunked. */
+	static constexpr int32 ElementsPerChunk = 16 * 1024;
+
+	/**
+	 * Formats NumElements items in chunks of ElementsPerChunk and writes the chunks in order.
+	 * FormatRange receives [Begin, End) ranges and, with bParallel set, runs on several threads at once,
+	 * so it must only read shared state. The bytes written are the same with or without bParallel.
+	 * Returns false if the export was cancelled through the progress object.
+	 */
+	bool WriteChunked(int32 NumElements, TFunctionRef<void(FMeshExportTextBuffer& Text, int32 Begin, int32 End)> FormatRange, bool bParallel = true);
+
+	/**
+	 * Reports WriteChunked progress to InProgress, as a fraction of TotalElements over all calls,
+	 * and stops writing once it is cancelled.
+	 */
+	void SetProgress(FMeshExportProgress* InProgress, int64 InTotalElements);
+
+	/**
+	 * Also copies everything written from now on into a second file, until EndCapture. The copy goes to a temporary
+	 * file first and only replaces CapturePath once it is complete.
+	 */
+	bool BeginCapture(const FString& InCapturePath);
+
+	/** Stops copying. The captured file is kept if bKeep is set and nothing failed; returns whether it was kept. */
+	bool EndCapture(bool bKeep);
+
+private:
+	void Flush();
+	/** Returns the chunk buffers to the context's pool, or frees them without one. */
+	void ReleaseChunkBuffers();
+	FString GetTempPath() const { return FilePath + TEXT(".tmp"); }
+
+	TUniquePtr<IFileHandle> File;
+	FString FilePath;
+	TUniquePtr<FArchive> CaptureArchive;
+	FString CapturePath;
+	TArray<uint8> Buffer;
+	TArray<FMeshExportTextBuffer> ChunkBuffers;
+	TSharedPtr<FMeshExportContext, ESPMode::ThreadSafe> Context;
+	int32 BufferSize;
+	int64 BytesWritten = 0;
+	FMeshExportProgress* Progress = nullptr;
+	int64 TotalElements = 0;
+	int64 ElementsDone = 0;
+	bool bError = false;
+	bool bCancelled = false;
+};
@@ -0,0 +1,119 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MeshMergeExportAsyncAction.h"
+#include "MeshMergerExporter.h"
+#include "Engine/World.h"
+#include "Engine/GameInstance.h"
+
+UMeshMergeExportAsyncAction* UMeshMergeExportAsyncAction::MergeAndExportMeshesAsync(AMeshMergerExporter* Exporter, const FString& ExportPath, bool bExportAsGLTF)
+{
+    UMeshMergeExportAsyncAction* Action = NewObject<UMeshMergeExportAsyncAction>();
+    Action->Exporter = Exporter;
+    Action->ExportPath = ExportPath;
+    Action->bExportAsGLTF = bExportAsGLTF;
+
+    UWorld* World = Exporter ? Exporter->GetWorld() : nullptr;
+    if (World && World->GetGameInstance())
+    {
+        Action->RegisterWithGameInstance(World->GetGameInstance());
+    }
+    else
+    {
+        Action->AddToRoot();
+        Action->bAddedToRoot = true;
+    }
+    return Action;
+}
+
+void UMeshMergeExportAsyncAction::SetReadyToDestroy()
+{
+    RemoveTicker();
+    if (bAddedToRoot)
+    {
+        RemoveFromRoot();
+        bAddedToRoot = false;
+    }
+    Super::SetReadyToDestroy();
+}
+
+void UMeshMergeExportAsyncAction::BeginDestroy()
+{
+    RemoveTicker();
+    Super::BeginDestroy();
+}
+
+void UMeshMergeExportAsyncAction::RemoveTicker()
+{
+    if (TickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+        TickerHandle.Reset();
+    }
+}
+
+void UMeshMergeExportAsyncAction::Activate()
+{
+    if (!Exporter)
+    {
+        UE_LOG(LogTemp, Error, TEXT("MergeAndExportMeshesAsync called without an exporter"));
+        OnFailed.Broadcast(0.0f, TEXT("No exporter"));
+        SetReadyToDestroy();
+        return;
+    }
+
+    Progress = MakeShared<FMeshExportProgress>();
+    Result = Exporter->MergeAndExportMeshesAsync(ExportPath, bExportAsGLTF, Progress.ToSharedRef());
+
+    // Progress is polled once per frame on the game thread, so the delegates never fire from a worker
+    TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UMeshMergeExportAsyncAction::Tick));
+}
+
+void UMeshMergeExportAsyncAction::Cancel()
+{
+    if (Progress)
+    {
+        Progress->Cancel();
+    }
+}
+
+bool UMeshMergeExportAsyncAction::Tick(float DeltaTime)
+{
+    ReportProgress();
+
+    if (!Result.IsReady())
+    {
+        return true;
+    }
+
+    const bool bSuccess = Result.Get();
+    const FString Stage = Progress->GetStageName();
+
+    if (bSuccess)
+    {
+        OnCompleted.Broadcast(1.0f, Stage);
+    }
+    else if (Progress->IsCancelled())
+    {
+        OnCancelled.Broadcast(Progress->GetProgress(), Stage);
+    }
+    else
+    {
+        OnFailed.Broadcast(Progress->GetProgress(), Stage);
+    }
+
+    SetReadyToDestroy();
+    return false;
+}
+
+void UMeshMergeExportAsyncAction::ReportProgress()
+{
+    const float CurrentProgress = Progress->GetProgress();
+    FString CurrentStage = Progress->GetStageName();
+
+    if (CurrentProgress != LastProgress || CurrentStage != LastStage)
+    {
+        LastProgress = CurrentProgress;
+        LastStage = MoveTemp(CurrentStage);
+        OnProgress.Broadcast(LastProgress, LastStage);
+    }
+}
@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "Async/Future.h"
+#include "Containers/Ticker.h"
+#include "MeshMergeExportAsyncAction.generated.h"
+
+class AMeshMergerExporter;
+class FMeshExportProgress;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FMeshMergeExportAsyncPin, float, Progress, const FString&, Stage);
+
+/** Blueprint node running AMeshMergerExporter::MergeAndExportMeshesAsync with progress and cancellation pins. */
+UCLASS()
+class SAFRAN_APP_API UMeshMergeExportAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	/** Merges and exports all static mesh actors of the exporter's level without freezing the game thread. */
+	UFUNCTION(BlueprintCallable, Category = "Mesh Merger", meta = (BlueprintInternalUseOnly = "true"))
+	static UMeshMergeExportAsyncAction* MergeAndExportMeshesAsync(AMeshMergerExporter* Exporter, const FString& ExportPath, bool bExportAsGLTF = true);
+
+	/** Asks the running export to stop. OnCancelled fires once it has. */
+	UFUNCTION(BlueprintCallable, Category = "Mesh Merger")
+	void Cancel();
+
+	/** Fires whenever the overall progress (0-1) or the stage changes. */
+	UPROPERTY(BlueprintAssignable)
+	FMeshMergeExportAsyncPin OnProgress;
+
+	UPROPERTY(BlueprintAssignable)
+	FMeshMergeExportAsyncPin OnCompleted;
+
+	UPROPERTY(BlueprintAssignable)
+	FMeshMergeExportAsyncPin OnFailed;
+
+	UPROPERTY(BlueprintAssignable)
+	FMeshMergeExportAsyncPin OnCancelled;
+
+	virtual void Activate() override;
+	virtual void SetReadyToDestroy() override;
+	virtual void BeginDestroy() override;
+
+private:
+	bool Tick(float DeltaTime);
+	void ReportProgress();
+	void RemoveTicker();
+
+	UPROPERTY()
+	TObjectPtr<AMeshMergerExporter> Exporter;
+
+	FString ExportPath;
+	bool bExportAsGLTF = true;
+
+	TSharedPtr<FMeshExportProgress> Progress;
+	TFuture<bool> Result;
+	FTSTicker::FDelegateHandle TickerHandle;
+
+	float LastProgress = -1.0f;
+	FString LastStage;
+
+	/** Editor worlds have no game instance to keep the action alive, so it is rooted until it finishes instead. */
+	bool bAddedToRoot = false;
+};
@@ -1,806 +1,1794 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#include "MeshMergerExporter.h"
-#include "Engine/World.h"
-#include "EngineUtils.h"
-#include "IMeshMergeUtilities.h"
-#include "Engine/StaticMesh.h"
-#include "Materials/Material.h"
-#include "Materials/MaterialInstance.h"
-#include "Materials/MaterialInstanceConstant.h"
-#include "Misc/FileHelper.h"
-#include "HAL/PlatformFileManager.h"
-#include "StaticMeshAttributes.h"
-#include "StaticMeshOperations.h"
-#include "MeshDescription.h"
-#include "AssetRegistry/AssetRegistryModule.h"
-#include "UObject/SavePackage.h"
-#include "ImageUtils.h"
-#include "IImageWrapper.h"
-#include "IImageWrapperModule.h"
-#include "MeshMergeModule.h"
-#include "Engine/Texture2D.h"
-#include "Rendering/SkeletalMeshLODImporterData.h"
-#include "Modules/ModuleManager.h"
-#include "TextureResource.h"
-
-AMeshMergerExporter::AMeshMergerExporter()
-{
-    PrimaryActorTick.bCanEverTick = false;
-}
-
-void AMeshMergerExporter::CollectStaticMeshActors(TArray<AStaticMeshActor*>& OutActors)
-{
-    OutActors.Empty();
-
-    UWorld* World = GetWorld();
-    if (!World) return;
-
-    for (TActorIterator<AStaticMeshActor> It(World); It; ++It)
-    {
-        AStaticMeshActor* Actor = *It;
-        if (Actor && Actor->GetStaticMeshComponent() && Actor->GetStaticMeshComponent()->GetStaticMesh())
-        {
-            OutActors.Add(Actor);
-        }
-    }
-
-    UE_LOG(LogTemp, Log, TEXT("Collected %d static mesh actors"), OutActors.Num());
-}
-
-bool AMeshMergerExporter::MergeMeshes(const TArray<AStaticMeshActor*>& Actors, UStaticMesh*& OutMergedMesh)
-{
-    if (Actors.Num() == 0)
-    {
-        UE_LOG(LogTemp, Error, TEXT("No actors to merge"));
-        return false;
-    }
-
-    // Prepare mesh merge settings
-    FMeshMergingSettings MergeSettings;
-    MergeSettings.bMergePhysicsData = false;
-    MergeSettings.bMergeMaterials = true;
-    MergeSettings.bBakeVertexDataToMesh = false;
-    MergeSettings.bUseVertexDataForBakingMaterial = false;
-    MergeSettings.bGenerateLightMapUV = false;
-
-    // Collect components
-    TArray<UPrimitiveComponent*> ComponentsToMerge;
-    for (AStaticMeshActor* Actor : Actors)
-    {
-        if (UStaticMeshComponent* SMC = Actor->GetStaticMeshComponent())
-        {
-            ComponentsToMerge.Add(SMC);
-        }
-    }
-
-    if (ComponentsToMerge.Num() == 0)
-    {
-        UE_LOG(LogTemp, Error, TEXT("No valid components to merge"));
-        return false;
-    }
-
-    UE_LOG(LogTemp, Log, TEXT("Merging %d components..."), ComponentsToMerge.Num());
-
-    // Get mesh utilities module
-    const IMeshMergeUtilities& MeshUtilities = FModuleManager::Get().LoadModuleChecked<IMeshMergeModule>("MeshMergeUtilities").GetUtilities();
-
-    // Use transient package for runtime merging
-    UPackage* Package = GetTransientPackage();
-
-    // Prepare output parameters
-    TArray<UObject*> OutAssetsToSync;
-    FVector OutMergedActorLocation = FVector::ZeroVector;
-
-    // Build the merged mesh
-    MeshUtilities.MergeComponentsToStaticMesh(
-        ComponentsToMerge,
-        GetWorld(),
-        MergeSettings,
-        nullptr, // InBaseMaterial
-        Package,
-        TEXT("MergedMesh"),
-        OutAssetsToSync,
-        OutMergedActorLocation,
-        1.0f, // ScreenAreaSize
-        false // bSilent
-    );
-
-    UE_LOG(LogTemp, Log, TEXT("MergeComponentsToStaticMesh returned %d assets"), OutAssetsToSync.Num());
-
-    // Check if merge was successful
-    if (OutAssetsToSync.Num() > 0)
-    {
-        for (UObject* Asset : OutAssetsToSync)
-        {
-            UE_LOG(LogTemp, Log, TEXT("Checking asset: %s (Type: %s)"),
-                *Asset->GetName(), *Asset->GetClass()->GetName());
-
-            if (UStaticMesh* StaticMesh = Cast<UStaticMesh>(Asset))
-            {
-                OutMergedMesh = StaticMesh;
-                UE_LOG(LogTemp, Log, TEXT("Successfully merged %d meshes into: %s"),
-                    ComponentsToMerge.Num(), *OutMergedMesh->GetName());
-
-                // Verify the mesh has valid data
-                if (OutMergedMesh->GetRenderData() != nullptr)
-                {
-                    UE_LOG(LogTemp, Log, TEXT("Merged mesh has valid render data"));
-                    return true;
-                }
-                else if (OutMergedMesh->GetMeshDescription(0) != nullptr)
-                {
-                    UE_LOG(LogTemp, Log, TEXT("Merged mesh has mesh description but no render data, attempting build"));
-
-                    // Try to build render data
-                    OutMergedMesh->NeverStream = true;
-                    OutMergedMesh->Build(false);
-                    OutMergedMesh->PostEditChange();
-
-                    if (OutMergedMesh->GetRenderData() != nullptr)
-                    {
-                        UE_LOG(LogTemp, Log, TEXT("Successfully built render data"));
-                        return true;
-                    }
-                    else
-                    {
-                        UE_LOG(LogTemp, Warning, TEXT("Failed to build render data, but mesh description exists - will attempt export anyway"));
-                        return true;
-                    }
-                }
-                else
-                {
-                    UE_LOG(LogTemp, Error, TEXT("Merged mesh has no render data or mesh description"));
-                    return false;
-                }
-            }
-        }
-    }
-
-    UE_LOG(LogTemp, Error, TEXT("Failed to merge meshes - no static mesh in output assets (got %d assets)"), OutAssetsToSync.Num());
-    return false;
-}
-
-FString AMeshMergerExporter::SanitizeFileName(const FString& FileName)
-{
-    FString Result = FileName;
-    Result = Result.Replace(TEXT(" "), TEXT("_"));
-    Result = Result.Replace(TEXT("/"), TEXT("_"));
-    Result = Result.Replace(TEXT("\\"), TEXT("_"));
-    Result = Result.Replace(TEXT(":"), TEXT("_"));
-    Result = Result.Replace(TEXT("*"), TEXT("_"));
-    Result = Result.Replace(TEXT("?"), TEXT("_"));
-    Result = Result.Replace(TEXT("\""), TEXT("_"));
-    Result = Result.Replace(TEXT("<"), TEXT("_"));
-    Result = Result.Replace(TEXT(">"), TEXT("_"));
-    Result = Result.Replace(TEXT("|"), TEXT("_"));
-    return Result;
-}
-
-void AMeshMergerExporter::ExportMaterials(UStaticMesh* Mesh, const FString& BasePath, const FString& OBJFileName)
-{
-    if (!Mesh) return;
-
-    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-
-    // Create Textures folder at the same level as OBJ file
-    FString TexturesPath = BasePath + TEXT("/Textures");
-    if (!PlatformFile.DirectoryExists(*TexturesPath))
-    {
-        PlatformFile.CreateDirectoryTree(*TexturesPath);
-        UE_LOG(LogTemp, Log, TEXT("Created directory: %s"), *TexturesPath);
-    }
-
-    TArray<FStaticMaterial> Materials = Mesh->GetStaticMaterials();
-    FString MTLContent;
-
-    UE_LOG(LogTemp, Log, TEXT("Exporting %d materials"), Materials.Num());
-    UE_LOG(LogTemp, Log, TEXT("Base path: %s"), *BasePath);
-    UE_LOG(LogTemp, Log, TEXT("Textures path: %s"), *TexturesPath);
-
-    for (int32 i = 0; i < Materials.Num(); i++)
-    {
-        UMaterialInterface* Material = Materials[i].MaterialInterface;
-        if (!Material)
-        {
-            UE_LOG(LogTemp, Warning, TEXT("Material %d is null"), i);
-            continue;
-        }
-
-        FString MaterialName = SanitizeFileName(Material->GetName());
-        UE_LOG(LogTemp, Log, TEXT("Processing material: %s"), *MaterialName);
-
-        // Create MTL file content
-        MTLContent += FString::Printf(TEXT("newmtl %s\n"), *MaterialName);
-        MTLContent += TEXT("Ka 1.000 1.000 1.000\n");
-        MTLContent += TEXT("Kd 1.000 1.000 1.000\n");
-        MTLContent += TEXT("Ks 0.000 0.000 0.000\n");
-        MTLContent += TEXT("Ns 10.0\n");
-        MTLContent += TEXT("d 1.0\n");
-        MTLContent += TEXT("illum 2\n");
-
-        // Try multiple parameter names for base color texture
-        UTexture* BaseColorTexture = nullptr;
-        TArray<FName> ParamNames = {
-            FName("BaseColor"),
-            FName("Diffuse"),
-            FName("DiffuseTexture"),
-            FName("BaseColorTexture"),
-            FName("Texture"),
-            FName("Albedo")
-        };
-
-        for (const FName& ParamName : ParamNames)
-        {
-            if (Material->GetTextureParameterValue(ParamName, BaseColorTexture))
-            {
-                UE_LOG(LogTemp, Log, TEXT("Found texture with parameter name: %s"), *ParamName.ToString());
-                break;
-            }
-        }
-
-        // Also try to get textures from material instance
-        if (!BaseColorTexture)
-        {
-            if (UMaterialInstanceConstant* MatInst = Cast<UMaterialInstanceConstant>(Material))
-            {
-                for (const FTextureParameterValue& TexParam : MatInst->TextureParameterValues)
-                {
-                    if (TexParam.ParameterValue)
-                    {
-                        BaseColorTexture = TexParam.ParameterValue;
-                        UE_LOG(LogTemp, Log, TEXT("Found texture from material instance: %s"), *TexParam.ParameterInfo.Name.ToString());
-                        break;
-                    }
-                }
-            }
-        }
-
-        bool bTextureExported = false;
-
-        if (BaseColorTexture)
-        {
-            UTexture2D* Texture2D = Cast<UTexture2D>(BaseColorTexture);
-            if (Texture2D)
-            {
-                // Check if this is a virtual texture
-                bool bIsVirtualTexture = Texture2D->VirtualTextureStreaming;
-                if (bIsVirtualTexture)
-                {
-                    UE_LOG(LogTemp, Warning, TEXT("Texture %s uses Virtual Texture Streaming - this may cause export issues. Consider disabling VT for this texture."), *Texture2D->GetName());
-                }
-
-                // Try TGA format first (simpler, more compatible)
-                FString TextureName = SanitizeFileName(Texture2D->GetName()) + TEXT(".tga");
-                FString TexturePath = TexturesPath + TEXT("/") + TextureName;
-
-                UE_LOG(LogTemp, Log, TEXT("Attempting to export texture: %s to %s (Virtual Texture: %s)"),
-                    *Texture2D->GetName(), *TexturePath, bIsVirtualTexture ? TEXT("Yes") : TEXT("No"));
-
-                // Get texture source data
-                FTextureSource& TextureSource = Texture2D->Source;
-                bool bUseAlternativeMethod = false;
-
-                if (TextureSource.IsValid())
-                {
-                    TArray64<uint8> RawData;
-                    TextureSource.GetMipData(RawData, 0);
-
-                    if (RawData.Num() > 0)
-                    {
-                        int32 Width = TextureSource.GetSizeX();
-                        int32 Height = TextureSource.GetSizeY();
-                        ETextureSourceFormat Format = TextureSource.GetFormat();
-
-                        UE_LOG(LogTemp, Log, TEXT("Texture size: %dx%d, Format: %d, Data size: %lld"),
-                            Width, Height, (int32)Format, RawData.Num());
-
-                        // Prepare BGRA data for TGA
-                        TArray<FColor> ColorData;
-                        ColorData.SetNum(Width * Height);
-
-                        bool bConversionSuccess = false;
-
-                        // Handle different source formats
-                        switch (Format)
-                        {
-                        case TSF_BGRA8:
-                        {
-                            // Copy directly as FColor expects BGRA
-                            for (int32 PixelIndex = 0; PixelIndex < Width * Height; PixelIndex++)
-                            {
-                                int32 ByteIndex = PixelIndex * 4;
-                                if (ByteIndex + 3 < RawData.Num())
-                                {
-                                    ColorData[PixelIndex] = FColor(
-                                        RawData[ByteIndex + 2], // R (from B position)
-                                        RawData[ByteIndex + 1], // G
-                                        RawData[ByteIndex + 0], // B (from R position)
-                                        RawData[ByteIndex + 3]  // A
-                                    );
-                                }
-                            }
-                            bConversionSuccess = true;
-                            break;
-                        }
-                        case TSF_G8:
-                        {
-                            // Grayscale to BGRA
-                            for (int32 PixelIndex = 0; PixelIndex < Width * Height; PixelIndex++)
-                            {
-                                if (PixelIndex < RawData.Num())
-                                {
-                                    uint8 Gray = RawData[PixelIndex];
-                                    ColorData[PixelIndex] = FColor(Gray, Gray, Gray, 255);
-                                }
-                            }
-                            bConversionSuccess = true;
-                            break;
-                        }
-                        default:
-                        {
-                            UE_LOG(LogTemp, Warning, TEXT("Unsupported texture format: %d, trying raw copy"), (int32)Format);
-                            // Try to interpret as BGRA anyway
-                            if (RawData.Num() >= Width * Height * 4)
-                            {
-                                for (int32 PixelIndex = 0; PixelIndex < Width * Height; PixelIndex++)
-                                {
-                                    int32 ByteIndex = PixelIndex * 4;
-                                    ColorData[PixelIndex] = FColor(
-                                        RawData[ByteIndex + 2],
-                                        RawData[ByteIndex + 1],
-                                        RawData[ByteIndex + 0],
-                                        RawData[ByteIndex + 3]
-                                    );
-                                }
-                                bConversionSuccess = true;
-                            }
-                            break;
-                        }
-                        }
-
-                        if (bConversionSuccess && ColorData.Num() > 0)
-                        {
-                            // Try TGA first
-                            IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
-                            TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::TGA);
-
-                            if (ImageWrapper.IsValid())
-                            {
-                                // TGA expects BGRA format which is what FColor provides
-                                if (ImageWrapper->SetRaw(ColorData.GetData(), ColorData.Num() * sizeof(FColor), Width, Height, ERGBFormat::BGRA, 8))
-                                {
-                                    const TArray64<uint8>& CompressedData = ImageWrapper->GetCompressed(100);
-                                    if (CompressedData.Num() > 0)
-                                    {
-                                        TArray<uint8> Data(CompressedData.GetData(), CompressedData.Num());
-                                        if (FFileHelper::SaveArrayToFile(Data, *TexturePath))
-                                        {
-                                            UE_LOG(LogTemp, Log, TEXT("Successfully exported TGA texture: %s (%d bytes)"),
-                                                *TexturePath, Data.Num());
-
-                                            // Use relative path without ./
-                                            MTLContent += FString::Printf(TEXT("map_Kd Textures/%s\n"), *TextureName);
-                                            bTextureExported = true;
-                                        }
-                                        else
-                                        {
-                                            UE_LOG(LogTemp, Error, TEXT("Failed to save TGA file: %s"), *TexturePath);
-                                        }
-                                    }
-                                }
-                            }
-
-                            // If TGA failed, try BMP (more widely supported)
-                            if (!bTextureExported)
-                            {
-                                TextureName = SanitizeFileName(Texture2D->GetName()) + TEXT(".bmp");
-                                TexturePath = TexturesPath + TEXT("/") + TextureName;
-
-                                ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::BMP);
-                                if (ImageWrapper.IsValid())
-                                {
-                                    if (ImageWrapper->SetRaw(ColorData.GetData(), ColorData.Num() * sizeof(FColor), Width, Height, ERGBFormat::BGRA, 8))
-                                    {
-                                        const TArray64<uint8>& CompressedData = ImageWrapper->GetCompressed(100);
-                                        if (CompressedData.Num() > 0)
-                                        {
-                                            TArray<uint8> Data(CompressedData.GetData(), CompressedData.Num());
-                                            if (FFileHelper::SaveArrayToFile(Data, *TexturePath))
-                                            {
-                                                UE_LOG(LogTemp, Log, TEXT("Successfully exported BMP texture: %s (%d bytes)"),
-                                                    *TexturePath, Data.Num());
-
-                                                MTLContent += FString::Printf(TEXT("map_Kd Textures/%s\n"), *TextureName);
-                                                bTextureExported = true;
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                        else
-                        {
-                            UE_LOG(LogTemp, Error, TEXT("Texture conversion failed"));
-                        }
-                    }
-                    else
-                    {
-                        UE_LOG(LogTemp, Warning, TEXT("Texture has no mip data, will try alternative method"));
-                        bUseAlternativeMethod = true;
-                    }
-                }
-                else
-                {
-                    UE_LOG(LogTemp, Warning, TEXT("Texture source is invalid, will try alternative method"));
-                    bUseAlternativeMethod = true;
-                }
-
-                // Alternative method for Virtual Textures or when source is unavailable
-                if (bUseAlternativeMethod && !bTextureExported)
-                {
-                    UE_LOG(LogTemp, Log, TEXT("Trying to export using alternative method..."));
-
-                    // Try to read texture data from platform data
-                    FTexturePlatformData* PlatformData = Texture2D->GetPlatformData();
-                    if (PlatformData && PlatformData->Mips.Num() > 0)
-                    {
-                        FTexture2DMipMap& Mip = PlatformData->Mips[0];
-                        void* MipData = Mip.BulkData.Lock(LOCK_READ_ONLY);
-
-                        if (MipData)
-                        {
-                            int32 Width = Mip.SizeX;
-                            int32 Height = Mip.SizeY;
-                            int32 DataSize = Mip.BulkData.GetBulkDataSize();
-
-                            UE_LOG(LogTemp, Log, TEXT("Got platform data: %dx%d, %d bytes"),
-                                Width, Height, DataSize);
-
-                            // Assume BGRA8 format for platform data
-                            TArray<FColor> OutBMP;
-                            OutBMP.SetNum(Width * Height);
-
-                            if (DataSize >= Width * Height * 4)
-                            {
-                                uint8* SourceData = static_cast<uint8*>(MipData);
-                                for (int32 PixIdx = 0; PixIdx < Width * Height; PixIdx++)
-                                {
-                                    int32 Idx = PixIdx * 4;
-                                    OutBMP[PixIdx] = FColor(
-                                        SourceData[Idx + 2], // R
-                                        SourceData[Idx + 1], // G
-                                        SourceData[Idx + 0], // B
-                                        SourceData[Idx + 3]  // A
-                                    );
-                                }
-
-                                Mip.BulkData.Unlock();
-
-                                // Try to save as TGA
-                                IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
-                                TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::TGA);
-
-                                if (ImageWrapper.IsValid())
-                                {
-                                    if (ImageWrapper->SetRaw(OutBMP.GetData(), OutBMP.Num() * sizeof(FColor), Width, Height, ERGBFormat::BGRA, 8))
-                                    {
-                                        const TArray64<uint8>& CompressedData = ImageWrapper->GetCompressed(100);
-                                        if (CompressedData.Num() > 0)
-                                        {
-                                            FString AltTextureName = SanitizeFileName(Texture2D->GetName()) + TEXT(".tga");
-                                            FString AltTexturePath = TexturesPath + TEXT("/") + AltTextureName;
-
-                                            TArray<uint8> Data(CompressedData.GetData(), CompressedData.Num());
-                                            if (FFileHelper::SaveArrayToFile(Data, *AltTexturePath))
-                                            {
-                                                UE_LOG(LogTemp, Log, TEXT("Successfully exported texture via platform data: %s"), *AltTexturePath);
-                                                MTLContent += FString::Printf(TEXT("map_Kd Textures/%s\n"), *AltTextureName);
-                                                bTextureExported = true;
-                                            }
-                                        }
-                                    }
-                                }
-
-                                // If TGA failed, try BMP
-                                if (!bTextureExported)
-                                {
-                                    FString AltTextureName = SanitizeFileName(Texture2D->GetName()) + TEXT(".bmp");
-                                    FString AltTexturePath = TexturesPath + TEXT("/") + AltTextureName;
-
-                                    ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::BMP);
-                                    if (ImageWrapper.IsValid())
-                                    {
-                                        if (ImageWrapper->SetRaw(OutBMP.GetData(), OutBMP.Num() * sizeof(FColor), Width, Height, ERGBFormat::BGRA, 8))
-                                        {
-                                            const TArray64<uint8>& CompressedData = ImageWrapper->GetCompressed(100);
-                                            if (CompressedData.Num() > 0)
-                                            {
-                                                TArray<uint8> Data(CompressedData.GetData(), CompressedData.Num());
-                                                if (FFileHelper::SaveArrayToFile(Data, *AltTexturePath))
-                                                {
-                                                    UE_LOG(LogTemp, Log, TEXT("Successfully exported BMP via platform data: %s"), *AltTexturePath);
-                                                    MTLContent += FString::Printf(TEXT("map_Kd Textures/%s\n"), *AltTextureName);
-                                                    bTextureExported = true;
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                            else
-                            {
-                                Mip.BulkData.Unlock();
-                                UE_LOG(LogTemp, Error, TEXT("Platform data size mismatch"));
-                            }
-                        }
-                        else
-                        {
-                            UE_LOG(LogTemp, Error, TEXT("Failed to lock mip data"));
-                        }
-                    }
-                    else
-                    {
-                        UE_LOG(LogTemp, Error, TEXT("No platform data available"));
-                    }
-                }
-            }
-            else
-            {
-                UE_LOG(LogTemp, Warning, TEXT("Failed to cast to UTexture2D"));
-            }
-        }
-        else
-        {
-            UE_LOG(LogTemp, Warning, TEXT("No base color texture found for material: %s"), *MaterialName);
-        }
-
-        if (!bTextureExported)
-        {
-            UE_LOG(LogTemp, Warning, TEXT("No texture exported for material: %s"), *MaterialName);
-        }
-
-        MTLContent += TEXT("\n");
-    }
-
-    // Save single MTL file for all materials - use same base name as OBJ file
-    FString MTLFileName = FPaths::GetBaseFilename(OBJFileName) + TEXT(".mtl");
-    FString MTLPath = BasePath + TEXT("/") + MTLFileName;
-
-    bool bSaved = FFileHelper::SaveStringToFile(MTLContent, *MTLPath);
-    UE_LOG(LogTemp, Log, TEXT("MTL file saved to: %s (Success: %d)"), *MTLPath, bSaved);
-
-    if (bSaved)
-    {
-        UE_LOG(LogTemp, Log, TEXT("=== MTL Content ===\n%s\n=== End MTL ==="), *MTLContent);
-
-        // Verify texture files exist
-        TArray<FString> FoundFiles;
-        IFileManager::Get().FindFiles(FoundFiles, *TexturesPath, TEXT("*.*"));
-        UE_LOG(LogTemp, Log, TEXT("Found %d files in Textures folder:"), FoundFiles.Num());
-        for (const FString& File : FoundFiles)
-        {
-            FString FullPath = TexturesPath + TEXT("/") + File;
-            int64 FileSize = IFileManager::Get().FileSize(*FullPath);
-            UE_LOG(LogTemp, Log, TEXT("  - %s (%lld bytes)"), *File, FileSize);
-        }
-    }
-}
-
-bool AMeshMergerExporter::ExportToOBJ(UStaticMesh* Mesh, const FString& FilePath)
-{
-    if (!Mesh)
-    {
-        UE_LOG(LogTemp, Error, TEXT("Cannot export null mesh"));
-        return false;
-    }
-
-    // Ensure mesh has valid render data
-    if (!Mesh->GetRenderData())
-    {
-        UE_LOG(LogTemp, Error, TEXT("Mesh has no render data"));
-        return false;
-    }
-
-    FString OBJContent;
-    FString BaseFileName = FPaths::GetBaseFilename(FilePath);
-    FString MTLFileName = BaseFileName + TEXT(".mtl");
-
-    OBJContent += FString::Printf(TEXT("# Exported from Unreal Engine 5\n"));
-    OBJContent += FString::Printf(TEXT("# Mesh: %s\n"), *Mesh->GetName());
-    OBJContent += FString::Printf(TEXT("mtllib %s\n\n"), *MTLFileName);
-
-    // Get mesh description for LOD 0
-    FMeshDescription* MeshDescription = Mesh->GetMeshDescription(0);
-    if (!MeshDescription)
-    {
-        UE_LOG(LogTemp, Error, TEXT("Failed to get mesh description"));
-        return false;
-    }
-
-    FStaticMeshConstAttributes Attributes(*MeshDescription);
-    TVertexAttributesConstRef<FVector3f> VertexPositions = Attributes.GetVertexPositions();
-    TVertexInstanceAttributesConstRef<FVector3f> VertexNormals = Attributes.GetVertexInstanceNormals();
-    TVertexInstanceAttributesConstRef<FVector2f> VertexUVs = Attributes.GetVertexInstanceUVs();
-
-    UE_LOG(LogTemp, Log, TEXT("Exporting %d vertices, %d triangles"),
-        MeshDescription->Vertices().Num(), MeshDescription->Triangles().Num());
-
-    // Build vertex instance to index mapping
-    TMap<FVertexInstanceID, int32> VertexInstanceToIndex;
-    int32 CurrentIndex = 1; // OBJ indices start at 1
-
-    // Export vertex positions
-    for (const FVertexID VertexID : MeshDescription->Vertices().GetElementIDs())
-    {
-        FVector3f Pos = VertexPositions[VertexID];
-        // Convert from UE coordinates (Z-up) to OBJ coordinates (Y-up)
-        OBJContent += FString::Printf(TEXT("v %.6f %.6f %.6f\n"), Pos.X, Pos.Z, Pos.Y);
-    }
-    OBJContent += TEXT("\n");
-
-    // Export texture coordinates
-    for (const FVertexInstanceID InstanceID : MeshDescription->VertexInstances().GetElementIDs())
-    {
-        FVector2f UV = VertexUVs.Get(InstanceID, 0);
-        OBJContent += FString::Printf(TEXT("vt %.6f %.6f\n"), UV.X, 1.0f - UV.Y);
-        VertexInstanceToIndex.Add(InstanceID, CurrentIndex++);
-    }
-    OBJContent += TEXT("\n");
-
-    // Export normals
-    for (const FVertexInstanceID InstanceID : MeshDescription->VertexInstances().GetElementIDs())
-    {
-        FVector3f Normal = VertexNormals[InstanceID];
-        // Convert from UE coordinates to OBJ coordinates
-        OBJContent += FString::Printf(TEXT("vn %.6f %.6f %.6f\n"), Normal.X, Normal.Z, Normal.Y);
-    }
-    OBJContent += TEXT("\n");
-
-    // Get polygon groups (sections) which correspond to materials
-    TArray<FStaticMaterial> Materials = Mesh->GetStaticMaterials();
-    TPolygonGroupAttributesConstRef<FName> PolygonGroupImportedMaterialSlotNames =
-        Attributes.GetPolygonGroupMaterialSlotNames();
-
-    UE_LOG(LogTemp, Log, TEXT("Mesh has %d materials/sections"), Materials.Num());
-
-    // Export faces grouped by material
-    for (int32 MatIndex = 0; MatIndex < Materials.Num(); MatIndex++)
-    {
-        if (!Materials[MatIndex].MaterialInterface)
-        {
-            UE_LOG(LogTemp, Warning, TEXT("Material %d is null"), MatIndex);
-            continue;
-        }
-
-        FString MaterialName = SanitizeFileName(Materials[MatIndex].MaterialInterface->GetName());
-        OBJContent += FString::Printf(TEXT("\n# Material: %s\n"), *MaterialName);
-        OBJContent += FString::Printf(TEXT("usemtl %s\n"), *MaterialName);
-
-        int32 FaceCount = 0;
-
-        // Iterate through all polygons
-        for (const FPolygonID PolygonID : MeshDescription->Polygons().GetElementIDs())
-        {
-            // Get the polygon group (material section) for this polygon
-            FPolygonGroupID PolygonGroupID = MeshDescription->GetPolygonPolygonGroup(PolygonID);
-
-            // Check if this polygon uses the current material
-            if (PolygonGroupID.GetValue() != MatIndex)
-            {
-                continue;
-            }
-
-            // Get triangles for this polygon
-            TArrayView<const FTriangleID> TriangleIDs = MeshDescription->GetPolygonTriangles(PolygonID);
-
-            for (const FTriangleID TriangleID : TriangleIDs)
-            {
-                TArrayView<const FVertexInstanceID> VertexInstances = MeshDescription->GetTriangleVertexInstances(TriangleID);
-
-                if (VertexInstances.Num() == 3)
-                {
-                    OBJContent += TEXT("f");
-                    for (int32 i = 0; i < 3; i++)
-                    {
-                        FVertexInstanceID InstanceID = VertexInstances[i];
-                        FVertexID VertexID = MeshDescription->GetVertexInstanceVertex(InstanceID);
-
-                        int32 VertexIndex = VertexID.GetValue() + 1;
-                        int32 UVNormalIndex = VertexInstanceToIndex[InstanceID];
-
-                        OBJContent += FString::Printf(TEXT(" %d/%d/%d"), VertexIndex, UVNormalIndex, UVNormalIndex);
-                    }
-                    OBJContent += TEXT("\n");
-                    FaceCount++;
-                }
-            }
-        }
-
-        UE_LOG(LogTemp, Log, TEXT("Exported %d faces for material: %s"), FaceCount, *MaterialName);
-    }
-
-    // Save OBJ file
-    bool bSuccess = FFileHelper::SaveStringToFile(OBJContent, *FilePath);
-
-    if (bSuccess)
-    {
-        UE_LOG(LogTemp, Log, TEXT("Successfully exported to OBJ: %s"), *FilePath);
-
-        // Export materials and textures
-        FString BasePath = FPaths::GetPath(FilePath);
-        FString OBJFileName = FPaths::GetCleanFilename(FilePath);
-        ExportMaterials(Mesh, BasePath, OBJFileName);
-    }
-    else
-    {
-        UE_LOG(LogTemp, Error, TEXT("Failed to save OBJ file: %s"), *FilePath);
-    }
-
-    return bSuccess;
-}
-
-bool AMeshMergerExporter::ExportToGLTF(UStaticMesh* Mesh, const FString& FilePath)
-{
-    // Note: GLTF export requires GLTFExporter plugin
-    // This is a simplified version - for full GLTF support, use the plugin
-
-    UE_LOG(LogTemp, Warning, TEXT("GLTF export requires GLTFExporter plugin. Falling back to OBJ export."));
-
-    FString OBJPath = FilePath.Replace(TEXT(".gltf"), TEXT(".obj"));
-    return ExportToOBJ(Mesh, OBJPath);
-}
-
-void AMeshMergerExporter::MergeAndExportMeshes(const FString& ExportPath, bool bExportAsGLTF)
-{
-    UE_LOG(LogTemp, Log, TEXT("Starting mesh merge and export process..."));
-
-    // Collect all static mesh actors
-    TArray<AStaticMeshActor*> StaticMeshActors;
-    CollectStaticMeshActors(StaticMeshActors);
-
-    if (StaticMeshActors.Num() == 0)
-    {
-        UE_LOG(LogTemp, Warning, TEXT("No static mesh actors found in level"));
-        return;
-    }
-
-    // Merge meshes
-    UStaticMesh* MergedMesh = nullptr;
-    if (!MergeMeshes(StaticMeshActors, MergedMesh))
-    {
-        UE_LOG(LogTemp, Error, TEXT("Failed to merge meshes"));
-        return;
-    }
-
-    if (!MergedMesh)
-    {
-        UE_LOG(LogTemp, Error, TEXT("Merged mesh is null"));
-        return;
-    }
-
-    // Ensure export directory exists
-    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-    FString ExportDir = FPaths::GetPath(ExportPath);
-    PlatformFile.CreateDirectoryTree(*ExportDir);
-
-    // Export to file
-    bool bSuccess = false;
-    if (bExportAsGLTF)
-    {
-        bSuccess = ExportToGLTF(MergedMesh, ExportPath);
-    }
-    else
-    {
-        bSuccess = ExportToOBJ(MergedMesh, ExportPath);
-    }
-
-    if (bSuccess)
-    {
-        UE_LOG(LogTemp, Log, TEXT("Successfully exported merged mesh to: %s"), *ExportPath);
-    }
-    else
-    {
-        UE_LOG(LogTemp, Error, TEXT("Failed to export merged mesh"));
-    }
-}
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MeshMergerExporter.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Engine/StaticMesh.h"
+#include "GameFramework/Volume.h"
+#include "WorldPartition/DataLayer/DataLayerAsset.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialInstance.h"
+#include "Misc/FileHelper.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "StaticMeshAttributes.h"
+#include "StaticMeshOperations.h"
+#include "MeshDescription.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "UObject/SavePackage.h"
+#include "ImageUtils.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Engine/Texture2D.h"
+#include "Rendering/SkeletalMeshLODImporterData.h"
+#include "Modules/ModuleManager.h"
+#include "TextureResource.h"
+#include "MeshExportMeshData.h"
+#include "MeshExportOBJWriter.h"
+#include "MeshExportGLBWriter.h"
+#include "MeshExportTextures.h"
+#include "MeshExportChunkCache.h"
+#include "Async/Async.h"
+#include "UObject/StrongObjectPtr.h"
+#include "StaticMeshResources.h"
+#include "Serialization/JsonWriter.h"
+#include "Misc/ScopeExit.h"
+#include "HAL/PlatformTime.h"
+#include "Templates/UnrealTemplate.h"
+
+#if WITH_EDITOR
+#include "IMeshMergeUtilities.h"
+#include "MeshMergeModule.h"
+#include "IMeshReductionInterfaces.h"
+#include "IMeshReductionManagerModule.h"
+#include "OverlappingCorners.h"
+#endif
+
+AMeshMergerExporter::AMeshMergerExporter()
+{
+    PrimaryActorTick.bCanEverTick = false;
+}
+
+bool AMeshMergerExporter::PassesFilter(const UStaticMeshComponent* Component) const
+{
+    return PassesComponentFilter(Component) && PassesBoundsFilter(Component->Bounds);
+}
+
+bool AMeshMergerExporter::PassesComponentFilter(const UStaticMeshComponent* Component) const
+{
+    const FMeshExportFilter& Filter = ExportSettings.Filter;
+    const AActor* Owner = Component->GetOwner();
+
+    // Cheap flag and tag tests first, mesh data last
+    if (Filter.bSkipHidden)
+    {
+        if (!Component->IsVisible() || (Owner && Owner->IsHidden()))
+        {
+            return false;
+        }
+#if WITH_EDITOR
+        if (Owner && Owner->IsHiddenEd())
+        {
+            return false;
+        }
+#endif
+    }
+
+    if (Filter.bSkipEditorOnly && (Component->IsEditorOnly() || (Owner && Owner->IsEditorOnly())))
+    {
+        return false;
+    }
+
+    if (Owner)
+    {
+        if (Filter.IncludeTags.Num() > 0 && !Filter.IncludeTags.ContainsByPredicate([Owner](const FName& Tag) { return Owner->ActorHasTag(Tag); }))
+        {
+            return false;
+        }
+
+        if (Filter.ExcludeTags.ContainsByPredicate([Owner](const FName& Tag) { return Owner->ActorHasTag(Tag); }))
+        {
+            return false;
+        }
+
+        if (Filter.DataLayers.Num() > 0 && !Filter.DataLayers.ContainsByPredicate([Owner](const TObjectPtr<UDataLayerAsset>& DataLayer)
+        {
+            return DataLayer && Owner->ContainsDataLayer(DataLayer);
+        }))
+        {
+            return false;
+        }
+    }
+
+    if (Filter.MaxTriangles > 0)
+    {
+        const FStaticMeshRenderData* RenderData = Component->GetStaticMesh()->GetRenderData();
+        if (RenderData && RenderData->LODResources.Num() > 0)
+        {
+            const int32 LODIndex = FMath::Clamp(ExportSettings.LODIndex, 0, RenderData->LODResources.Num() - 1);
+            if (RenderData->LODResources[LODIndex].GetNumTriangles() > static_cast<uint32>(Filter.MaxTriangles))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool AMeshMergerExporter::PassesBoundsFilter(const FBoxSphereBounds& Bounds) const
+{
+    const FMeshExportFilter& Filter = ExportSettings.Filter;
+    if (Filter.bUseBounds && !Filter.Bounds.IsInsideOrOn(Bounds.Origin))
+    {
+        return false;
+    }
+
+    if (Filter.Volume && !Filter.Volume->EncompassesPoint(Bounds.Origin))
+    {
+        return false;
+    }
+
+    return Bounds.SphereRadius >= Filter.MinBoundsRadius;
+}
+
+void AMeshMergerExporter::CollectStaticMeshActors(TArray<AStaticMeshActor*>& OutActors)
+{
+    OutActors.Empty();
+
+    UWorld* World = GetWorld();
+    if (!World) return;
+
+    int32 NumFiltered = 0;
+    for (TActorIterator<AStaticMeshActor> It(World); It; ++It)
+    {
+        AStaticMeshActor* Actor = *It;
+        if (Actor && Actor->GetStaticMeshComponent() && Actor->GetStaticMeshComponent()->GetStaticMesh())
+        {
+            if (!PassesFilter(Actor->GetStaticMeshComponent()))
+            {
+                NumFiltered++;
+                continue;
+            }
+            OutActors.Add(Actor);
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Collected %d static mesh actors, %d filtered out"), OutActors.Num(), NumFiltered);
+}
+
+void AMeshMergerExporter::CollectInstancedMeshComponents(TArray<FMeshExportInstancedSelection>& OutSelections)
+{
+    OutSelections.Empty();
+
+    UWorld* World = GetWorld();
+    if (!World) return;
+
+    // Instanced components can sit on any actor (foliage, blueprints, packed level actors); HISM derives from ISM
+    TArray<UInstancedStaticMeshComponent*> Components;
+    int64 NumInstances = 0;
+    int64 NumFiltered = 0;
+    for (TActorIterator<AActor> It(World); It; ++It)
+    {
+        It->GetComponents(Components);
+        for (UInstancedStaticMeshComponent* Component : Components)
+        {
+            if (!Component || !Component->GetStaticMesh() || Component->GetInstanceCount() == 0)
+            {
+                continue;
+            }
+            if (!PassesComponentFilter(Component))
+            {
+                NumFiltered += Component->GetInstanceCount();
+                continue;
+            }
+
+            // A level-wide foliage component spans every tile and bounds filter, so its instances are tested one by one
+            FMeshExportInstancedSelection Selection;
+            Selection.Component = Component;
+            const FBoxSphereBounds MeshBounds = Component->GetStaticMesh()->GetBounds();
+            for (int32 InstanceIndex = 0; InstanceIndex < Component->GetInstanceCount(); InstanceIndex++)
+            {
+                FTransform InstanceTransform;
+                if (Component->GetInstanceTransform(InstanceIndex, InstanceTransform, true) && PassesBoundsFilter(MeshBounds.TransformBy(InstanceTransform)))
+                {
+                    Selection.InstanceIndices.Add(InstanceIndex);
+                }
+                else
+                {
+                    NumFiltered++;
+                }
+            }
+
+            if (Selection.InstanceIndices.Num() > 0)
+            {
+                NumInstances += Selection.InstanceIndices.Num();
+                OutSelections.Add(MoveTemp(Selection));
+            }
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Collected %lld instances of %d instanced static mesh components, %lld filtered out"), NumInstances, OutSelections.Num(), NumFiltered);
+}
+
+bool AMeshMergerExporter::MergeMeshes(const TArray<AStaticMeshActor*>& Actors, UStaticMesh*& OutMergedMesh, const FString& MeshName, TArray<UObject*>* OutCreatedAssets)
+{
+    if (Actors.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("No actors to merge"));
+        return false;
+    }
+
+#if WITH_EDITOR
+
+    // Prepare mesh merge settings
+    FMeshMergingSettings MergeSettings;
+    MergeSettings.bMergePhysicsData = false;
+    MergeSettings.bMergeMaterials = true;
+    MergeSettings.bBakeVertexDataToMesh = false;
+    MergeSettings.bUseVertexDataForBakingMaterial = false;
+    MergeSettings.bGenerateLightMapUV = false;
+
+    // Only the exported LOD of each component is merged; the merged mesh then has it as its only LOD
+    MergeSettings.LODSelectionType = EMeshLODSelectionType::SpecificLOD;
+    MergeSettings.SpecificLOD = FMath::Max(ExportSettings.LODIndex, 0);
+
+    // Collect components
+    TArray<UPrimitiveComponent*> ComponentsToMerge;
+    for (AStaticMeshActor* Actor : Actors)
+    {
+        if (UStaticMeshComponent* SMC = Actor->GetStaticMeshComponent())
+        {
+            ComponentsToMerge.Add(SMC);
+        }
+    }
+
+    if (ComponentsToMerge.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("No valid components to merge"));
+        return false;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Merging %d components..."), ComponentsToMerge.Num());
+
+    // Get mesh utilities module
+    const IMeshMergeUtilities& MeshUtilities = FModuleManager::Get().LoadModuleChecked<IMeshMergeModule>("MeshMergeUtilities").GetUtilities();
+
+    // Use transient package for runtime merging
+    UPackage* Package = GetTransientPackage();
+
+    // Prepare output parameters
+    TArray<UObject*> OutAssetsToSync;
+    FVector OutMergedActorLocation = FVector::ZeroVector;
+
+    // Build the merged mesh
+    {
+        MESH_EXPORT_STAGE_SCOPE(ActiveReport, TEXT("Merge components"), nullptr, true);
+        MeshUtilities.MergeComponentsToStaticMesh(
+            ComponentsToMerge,
+            GetWorld(),
+            MergeSettings,
+            nullptr, // InBaseMaterial
+            Package,
+            MeshName,
+            OutAssetsToSync,
+            OutMergedActorLocation,
+            1.0f, // ScreenAreaSize
+            false // bSilent
+        );
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("MergeComponentsToStaticMesh returned %d assets"), OutAssetsToSync.Num());
+
+    // The mesh, baked materials and atlas textures, so the caller can release them whether or not the merge worked
+    if (OutCreatedAssets)
+    {
+        *OutCreatedAssets = OutAssetsToSync;
+    }
+
+    // Check if merge was successful
+    if (OutAssetsToSync.Num() > 0)
+    {
+        for (UObject* Asset : OutAssetsToSync)
+        {
+            UE_LOG(LogTemp, Log, TEXT("Checking asset: %s (Type: %s)"),
+                *Asset->GetName(), *Asset->GetClass()->GetName());
+
+            if (UStaticMesh* StaticMesh = Cast<UStaticMesh>(Asset))
+            {
+                OutMergedMesh = StaticMesh;
+                UE_LOG(LogTemp, Log, TEXT("Successfully merged %d meshes into: %s"),
+                    ComponentsToMerge.Num(), *OutMergedMesh->GetName());
+
+                // Verify the mesh has valid data
+                if (OutMergedMesh->GetRenderData() != nullptr)
+                {
+                    UE_LOG(LogTemp, Log, TEXT("Merged mesh has valid render data"));
+                    return true;
+                }
+                else if (OutMergedMesh->GetMeshDescription(0) != nullptr && !ExportSettings.bExportFromRenderData)
+                {
+                    // The export reads the mesh description, so there is no need to build render data for it
+                    UE_LOG(LogTemp, Log, TEXT("Merged mesh has mesh description but no render data, exporting from the mesh description"));
+                    return true;
+                }
+                else if (OutMergedMesh->GetMeshDescription(0) != nullptr)
+                {
+                    UE_LOG(LogTemp, Log, TEXT("Merged mesh has mesh description but no render data, attempting build"));
+
+                    // Try to build render data
+                    {
+                        MESH_EXPORT_STAGE_SCOPE(ActiveReport, TEXT("Build render data"), nullptr, true);
+                        OutMergedMesh->NeverStream = true;
+                        OutMergedMesh->Build(false);
+                        OutMergedMesh->PostEditChange();
+                    }
+
+                    if (OutMergedMesh->GetRenderData() != nullptr)
+                    {
+                        UE_LOG(LogTemp, Log, TEXT("Successfully built render data"));
+                        return true;
+                    }
+                    else
+                    {
+                        UE_LOG(LogTemp, Warning, TEXT("Failed to build render data, but mesh description exists - will attempt export anyway"));
+                        return true;
+                    }
+                }
+                else
+                {
+                    UE_LOG(LogTemp, Error, TEXT("Merged mesh has no render data or mesh description"));
+                    return false;
+                }
+            }
+        }
+    }
+
+    UE_LOG(LogTemp, Error, TEXT("Failed to merge meshes - no static mesh in output assets (got %d assets)"), OutAssetsToSync.Num());
+    return false;
+#else
+    // The mesh merge utilities are an editor module
+    UE_LOG(LogTemp, Error, TEXT("Merging meshes is only available in editor builds"));
+    return false;
+#endif
+}
+
+FString AMeshMergerExporter::SanitizeFileName(const FString& FileName)
+{
+    FString Result = FileName;
+    Result = Result.Replace(TEXT(" "), TEXT("_"));
+    Result = Result.Replace(TEXT("/"), TEXT("_"));
+    Result = Result.Replace(TEXT("\\"), TEXT("_"));
+    Result = Result.Replace(TEXT(":"), TEXT("_"));
+    Result = Result.Replace(TEXT("*"), TEXT("_"));
+    Result = Result.Replace(TEXT("?"), TEXT("_"));
+    Result = Result.Replace(TEXT("\""), TEXT("_"));
+    Result = Result.Replace(TEXT("<"), TEXT("_"));
+    Result = Result.Replace(TEXT(">"), TEXT("_"));
+    Result = Result.Replace(TEXT("|"), TEXT("_"));
+    return Result;
+}
+
+void AMeshMergerExporter::CollectMaterialExports(UStaticMesh* Mesh, const FString& BasePath, FMeshExportTextureExporter& TextureExporter, TArray<FMeshExportMaterialEntry>& OutMaterials)
+{
+    TArray<UMaterialInterface*> Materials;
+    for (const FStaticMaterial& Material : Mesh->GetStaticMaterials())
+    {
+        Materials.Add(Material.MaterialInterface);
+    }
+    CollectMaterialExports(Materials, BasePath, TextureExporter, OutMaterials);
+}
+
+void AMeshMergerExporter::CollectMaterialExports(TConstArrayView<UMaterialInterface*> Materials, const FString& BasePath, FMeshExportTextureExporter& TextureExporter, TArray<FMeshExportMaterialEntry>& OutMaterials)
+{
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+    // Create Textures folder at the same level as OBJ file
+    FString TexturesPath = BasePath + TEXT("/Textures");
+    if (!PlatformFile.DirectoryExists(*TexturesPath))
+    {
+        PlatformFile.CreateDirectoryTree(*TexturesPath);
+        UE_LOG(LogTemp, Log, TEXT("Created directory: %s"), *TexturesPath);
+    }
+
+    // Textures unchanged since a previous export into this folder are not written again
+    if (ExportSettings.bUseTextureCache && !TextureExporter.IsDiskCacheEnabled())
+    {
+        TextureExporter.EnableDiskCache(TexturesPath);
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Exporting %d materials"), Materials.Num());
+    UE_LOG(LogTemp, Log, TEXT("Base path: %s"), *BasePath);
+    UE_LOG(LogTemp, Log, TEXT("Textures path: %s"), *TexturesPath);
+
+    for (int32 i = 0; i < Materials.Num(); i++)
+    {
+        UMaterialInterface* Material = Materials[i];
+        if (!Material)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Material %d is null"), i);
+            continue;
+        }
+
+        FMeshExportMaterialEntry& Entry = OutMaterials.AddDefaulted_GetRef();
+        Entry.MaterialName = SanitizeFileName(Material->GetName());
+
+        // Instances of the same parent share its parameter lookup, and every material is only looked up once per export
+        const FMeshExportMaterialTextures& Textures = MaterialResolver.Resolve(Material);
+        if (!Textures.Get(EMeshExportMaterialChannel::BaseColor))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("No base color texture found for material: %s"), *Entry.MaterialName);
+        }
+
+        // Base color is the first channel
+        const int32 NumChannels = ExportSettings.bExportPBRTextures ? MeshExportNumMaterialChannels : 1;
+        for (int32 Channel = 0; Channel < NumChannels; Channel++)
+        {
+            // The textures themselves are decoded and written later, together with all the others
+            if (UTexture2D* Texture = Textures.Textures[Channel])
+            {
+                Entry.TextureJobs[Channel] = TextureExporter.AddTexture(Texture, SanitizeFileName(Texture->GetName()), TexturesPath);
+            }
+        }
+    }
+}
+
+bool AMeshMergerExporter::WriteMTL(const TArray<FMeshExportMaterialEntry>& Materials, const FMeshExportTextureExporter& TextureExporter, const FString& BasePath, const FString& OBJFileName, FMeshExportReport* Report)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_STR(TEXT("Write MTL"));
+    FMeshExportStageTimer Timer(Report, TEXT("Write MTL"));
+    FString MTLContent;
+
+    for (const FMeshExportMaterialEntry& Entry : Materials)
+    {
+        // Create MTL file content
+        MTLContent += FString::Printf(TEXT("newmtl %s\n"), *Entry.MaterialName);
+        MTLContent += TEXT("Ka 1.000 1.000 1.000\n");
+        MTLContent += TEXT("Kd 1.000 1.000 1.000\n");
+        MTLContent += TEXT("Ks 0.000 0.000 0.000\n");
+        MTLContent += TEXT("Ns 10.0\n");
+        MTLContent += TEXT("d 1.0\n");
+        MTLContent += TEXT("illum 2\n");
+
+        auto GetTextureFileName = [&Entry, &TextureExporter](EMeshExportMaterialChannel Channel) -> const FString*
+        {
+            const int32 JobIndex = Entry.GetTextureJob(Channel);
+            return JobIndex != INDEX_NONE && !TextureExporter.GetJob(JobIndex).ExportedFileName.IsEmpty()
+                ? &TextureExporter.GetJob(JobIndex).ExportedFileName
+                : nullptr;
+        };
+
+        if (const FString* TextureFileName = GetTextureFileName(EMeshExportMaterialChannel::BaseColor))
+        {
+            // Use relative path without ./
+            MTLContent += FString::Printf(TEXT("map_Kd Textures/%s\n"), **TextureFileName);
+        }
+        else
+        {
+            UE_LOG(LogTemp, Warning, TEXT("No texture exported for material: %s"), *Entry.MaterialName);
+        }
+
+        // PBR extension maps. A texture feeding both roughness and metallic is a packed ORM texture, read per channel.
+        // MTL has no occlusion map, so that channel is only used by glTF.
+        const bool bPackedORM = Entry.GetTextureJob(EMeshExportMaterialChannel::Roughness) != INDEX_NONE
+            && Entry.GetTextureJob(EMeshExportMaterialChannel::Roughness) == Entry.GetTextureJob(EMeshExportMaterialChannel::Metallic);
+        if (const FString* TextureFileName = GetTextureFileName(EMeshExportMaterialChannel::Normal))
+        {
+            MTLContent += FString::Printf(TEXT("norm Textures/%s\n"), **TextureFileName);
+        }
+        if (const FString* TextureFileName = GetTextureFileName(EMeshExportMaterialChannel::Roughness))
+        {
+            MTLContent += FString::Printf(TEXT("map_Pr %sTextures/%s\n"), bPackedORM ? TEXT("-imfchan g ") : TEXT(""), **TextureFileName);
+        }
+        if (const FString* TextureFileName = GetTextureFileName(EMeshExportMaterialChannel::Metallic))
+        {
+            MTLContent += FString::Printf(TEXT("map_Pm %sTextures/%s\n"), bPackedORM ? TEXT("-imfchan b ") : TEXT(""), **TextureFileName);
+        }
+        if (const FString* TextureFileName = GetTextureFileName(EMeshExportMaterialChannel::Emissive))
+        {
+            MTLContent += TEXT("Ke 1.000 1.000 1.000\n");
+            MTLContent += FString::Printf(TEXT("map_Ke Textures/%s\n"), **TextureFileName);
+        }
+
+        MTLContent += TEXT("\n");
+    }
+
+    // Save single MTL file for all materials - use same base name as OBJ file
+    FString MTLFileName = FPaths::GetBaseFilename(OBJFileName) + TEXT(".mtl");
+    FString MTLPath = BasePath + TEXT("/") + MTLFileName;
+
+    bool bSaved = FFileHelper::SaveStringToFile(MTLContent, *MTLPath);
+    UE_LOG(LogTemp, Log, TEXT("MTL file saved to: %s (Success: %d)"), *MTLPath, bSaved);
+
+    if (bSaved)
+    {
+        Timer.AddBytes(IFileManager::Get().FileSize(*MTLPath));
+    }
+    return bSaved;
+}
+
+void AMeshMergerExporter::ExportMaterials(UStaticMesh* Mesh, const FString& BasePath, const FString& OBJFileName)
+{
+    if (!Mesh) return;
+
+    FMeshExportTextureExporter TextureExporter;
+    TextureExporter.Configure(ExportSettings, false);
+    TArray<FMeshExportMaterialEntry> Materials;
+    CollectMaterialExports(Mesh, BasePath, TextureExporter, Materials);
+
+    // Decode, convert, encode and write every texture in parallel; the MTL file waits for the results
+    ProcessTextureJobs(TextureExporter, ExportSettings, ActiveReport);
+
+    WriteMTL(Materials, TextureExporter, BasePath, OBJFileName, ActiveReport);
+}
+
+void AMeshMergerExporter::ProcessTextureJobs(FMeshExportTextureExporter& TextureExporter, const FMeshExportSettings& Settings, FMeshExportReport* Report)
+{
+    {
+        MESH_EXPORT_STAGE_SCOPE(Report, TEXT("Textures"), nullptr, true);
+        TextureExporter.ProcessJobs(Settings.MaxConcurrentTextureJobs);
+
+        // Reading platform data needs the game thread; it is only used for textures without source data
+        if (TextureExporter.PreparePlatformDataFallbacks())
+        {
+            TextureExporter.ProcessJobs(Settings.MaxConcurrentTextureJobs);
+        }
+        TextureExporter.SaveDiskCache();
+    }
+
+    if (Report)
+    {
+        TextureExporter.AddToReport(*Report);
+    }
+}
+
+void AMeshMergerExporter::FinishReport(FMeshExportReport& Report, const FMeshExportSettings& Settings, double StartTime, bool bSuccess)
+{
+    Report.Finish(FPlatformTime::Seconds() - StartTime, bSuccess);
+
+    UE_LOG(LogTemp, Log, TEXT("Export took %.3f s, used memory up to %lld MB"), Report.TotalSeconds, Report.MaxUsedPhysical / (1024 * 1024));
+    for (const FMeshExportStageReport& Stage : Report.Stages)
+    {
+        UE_LOG(LogTemp, Log, TEXT("  %s: %.3f s over %d runs, %lld bytes written"), *Stage.Name, Stage.Seconds, Stage.Count, Stage.BytesWritten);
+    }
+
+    if (Settings.bWriteExportReport && !Report.FilePath.IsEmpty())
+    {
+        const FString ReportPath = FPaths::GetPath(Report.FilePath) / (FPaths::GetBaseFilename(Report.FilePath) + TEXT("_report.json"));
+        if (Report.SaveJson(ReportPath))
+        {
+            UE_LOG(LogTemp, Log, TEXT("Export report saved to: %s"), *ReportPath);
+        }
+    }
+}
+
+void AMeshMergerExporter::BuildGLBMaterials(const TArray<FMeshExportMaterialEntry>& Materials, const FMeshExportTextureExporter& TextureExporter, TArray<FMeshExportGLBMaterial>& OutMaterials)
+{
+    for (const FMeshExportMaterialEntry& Entry : Materials)
+    {
+        FMeshExportGLBMaterial& GLBMaterial = OutMaterials.AddDefaulted_GetRef();
+        GLBMaterial.Name = Entry.MaterialName;
+
+        for (int32 Channel = 0; Channel < MeshExportNumMaterialChannels; Channel++)
+        {
+            if (Entry.TextureJobs[Channel] != INDEX_NONE)
+            {
+                const FMeshExportTextureJob& Job = TextureExporter.GetJob(Entry.TextureJobs[Channel]);
+                if (!Job.ExportedFileName.IsEmpty())
+                {
+                    GLBMaterial.TexturePaths[Channel] = Job.OutputDirectory / Job.ExportedFileName;
+                    GLBMaterial.TextureURIs[Channel] = TEXT("Textures/") + Job.ExportedFileName;
+                }
+            }
+        }
+    }
+}
+
+void AMeshMergerExporter::DeleteEmbeddedImages(const TArray<FMeshExportGLBMaterial>& Materials, const FMeshExportTextureExporter& TextureExporter, const FMeshExportSettings& Settings)
+{
+    if (!Settings.bEmbedTextures || TextureExporter.IsDiskCacheEnabled())
+    {
+        return;
+    }
+
+    TSet<FString> Directories;
+    for (const FMeshExportGLBMaterial& Material : Materials)
+    {
+        for (const FString& TexturePath : Material.TexturePaths)
+        {
+            if (!TexturePath.IsEmpty() && IFileManager::Get().Delete(*TexturePath, false, false, true))
+            {
+                Directories.Add(FPaths::GetPath(TexturePath));
+            }
+        }
+    }
+
+    // Only removes the Textures folder if nothing else is left in it
+    for (const FString& Directory : Directories)
+    {
+        IFileManager::Get().DeleteDirectory(*Directory, false, false);
+    }
+}
+
+#if WITH_EDITOR
+// Simplifies InMesh to TriangleRatio of its triangles with the static mesh reduction the editor is set up with
+static bool ReduceMeshDescription(const FMeshDescription& InMesh, float TriangleRatio, FMeshDescription& OutMesh)
+{
+    IMeshReduction* Reduction = FModuleManager::Get().LoadModuleChecked<IMeshReductionManagerModule>("MeshReductionInterface").GetStaticMeshReductionInterface();
+    if (!Reduction)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("No mesh reduction module available, exporting full detail"));
+        return false;
+    }
+
+    FOverlappingCorners OverlappingCorners;
+    FStaticMeshOperations::FindOverlappingCorners(OverlappingCorners, InMesh, THRESH_POINTS_ARE_SAME);
+
+    FMeshReductionSettings ReductionSettings;
+    ReductionSettings.PercentTriangles = TriangleRatio;
+    ReductionSettings.TerminationCriterion = EStaticMeshReductionTerimationCriterion::Triangles;
+
+    OutMesh = InMesh;
+    float MaxDeviation = 0.0f;
+    Reduction->ReduceMeshDescription(OutMesh, MaxDeviation, InMesh, OverlappingCorners, ReductionSettings);
+    return OutMesh.Triangles().Num() > 0;
+}
+#endif
+
+int64 AMeshMergerExporter::GetSourceTriangleCount(UStaticMesh* Mesh, int32 LODIndex) const
+{
+#if WITH_EDITORONLY_DATA
+    if (!ExportSettings.bExportFromRenderData)
+    {
+        if (const FMeshDescription* MeshDescription = Mesh->GetMeshDescription(FMath::Clamp(LODIndex, 0, FMath::Max(Mesh->GetNumSourceModels() - 1, 0))))
+        {
+            return MeshDescription->Triangles().Num();
+        }
+    }
+#endif
+
+    const FStaticMeshRenderData* RenderData = Mesh->GetRenderData();
+    if (!RenderData || RenderData->LODResources.Num() == 0)
+    {
+        return 0;
+    }
+    return RenderData->LODResources[FMath::Clamp(LODIndex, 0, RenderData->LODResources.Num() - 1)].GetNumTriangles();
+}
+
+float AMeshMergerExporter::GetTriangleRatio(int64 NumTriangles) const
+{
+    const int64 Target = ExportSettings.TargetTriangleCount;
+    if (Target <= 0 || NumTriangles <= Target)
+    {
+        return 1.0f;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Reducing %lld triangles to about %lld"), NumTriangles, Target);
+    return static_cast<float>(static_cast<double>(Target) / NumTriangles);
+}
+
+bool AMeshMergerExporter::BuildExportData(UStaticMesh* Mesh, FMeshExportMeshData& OutData)
+{
+    if (!Mesh)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Cannot export null mesh"));
+        return false;
+    }
+
+    TArray<UMaterialInterface*> Materials;
+    for (const FStaticMaterial& Material : Mesh->GetStaticMaterials())
+    {
+        Materials.Add(Material.MaterialInterface);
+    }
+
+    // Merged meshes only hold the LOD picked when merging, so the first one is exported
+    if (!BuildExportData(Mesh, Materials, 0, GetTriangleRatio(GetSourceTriangleCount(Mesh, 0)), OutData))
+    {
+        return false;
+    }
+
+    if (ExportSettings.bOptimizeVertexOrder)
+    {
+        MESH_EXPORT_STAGE_SCOPE(ActiveReport, TEXT("Optimize vertex order"));
+        OutData.OptimizeVertexOrder();
+    }
+    return true;
+}
+
+bool AMeshMergerExporter::BuildExportData(UStaticMesh* Mesh, TConstArrayView<UMaterialInterface*> Materials, int32 LODIndex, float TriangleRatio, FMeshExportMeshData& OutData)
+{
+    MESH_EXPORT_STAGE_SCOPE(ActiveReport, TEXT("Read mesh data"));
+
+    // Material slots without a material are left out of the export
+    TArray<FString> MaterialNames;
+    for (UMaterialInterface* Material : Materials)
+    {
+        MaterialNames.Add(Material ? SanitizeFileName(Material->GetName()) : FString());
+    }
+
+    OutData.Name = Mesh->GetName();
+
+#if WITH_EDITORONLY_DATA
+    if (!ExportSettings.bExportFromRenderData)
+    {
+        // Generated LODs have no mesh description of their own, they are read from the render data below
+        const int32 SourceLOD = FMath::Clamp(LODIndex, 0, FMath::Max(Mesh->GetNumSourceModels() - 1, 0));
+        FMeshDescription* MeshDescription = Mesh->GetMeshDescription(SourceLOD);
+        if (MeshDescription)
+        {
+#if WITH_EDITOR
+            FMeshDescription ReducedMesh;
+            bool bReduced = false;
+            if (TriangleRatio < 1.0f)
+            {
+                MESH_EXPORT_STAGE_SCOPE(ActiveReport, TEXT("Reduce mesh"));
+                bReduced = ReduceMeshDescription(*MeshDescription, TriangleRatio, ReducedMesh);
+            }
+
+            if (bReduced)
+            {
+                UE_LOG(LogTemp, Log, TEXT("Reduced %s from %d to %d triangles"), *Mesh->GetName(),
+                    MeshDescription->Triangles().Num(), ReducedMesh.Triangles().Num());
+                return OutData.BuildFromMeshDescription(ReducedMesh, MaterialNames);
+            }
+#endif
+            return OutData.BuildFromMeshDescription(*MeshDescription, MaterialNames);
+        }
+
+        if (SourceLOD == 0)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Failed to get mesh description"));
+            return false;
+        }
+        UE_LOG(LogTemp, Log, TEXT("LOD %d of %s is generated, reading it from the render data"), SourceLOD, *Mesh->GetName());
+    }
+#endif
+
+    // Render data is all that is left of the mesh in cooked builds
+    FStaticMeshRenderData* RenderData = Mesh->GetRenderData();
+    if (!RenderData || RenderData->LODResources.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Mesh has no render data"));
+        return false;
+    }
+
+    int32 RenderLOD = FMath::Clamp(LODIndex, 0, RenderData->LODResources.Num() - 1);
+
+    // Render data cannot be reduced, so a triangle budget is met by moving down to coarser LODs instead
+    if (TriangleRatio < 1.0f)
+    {
+        const double TargetTriangles = RenderData->LODResources[RenderLOD].GetNumTriangles() * static_cast<double>(TriangleRatio);
+        while (RenderLOD + 1 < RenderData->LODResources.Num() && RenderData->LODResources[RenderLOD].GetNumTriangles() > TargetTriangles)
+        {
+            RenderLOD++;
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Exporting %s from render data LOD %d"), *Mesh->GetName(), RenderLOD);
+    return OutData.BuildFromRenderData(RenderData->LODResources[RenderLOD], MaterialNames);
+}
+
+FString AMeshMergerExporter::GetGeometryCacheDirectory(const FString& FilePath)
+{
+    return FPaths::GetPath(FilePath) / (FPaths::GetBaseFilename(FilePath) + TEXT("_GeometryCache"));
+}
+
+// Everything the serialized geometry of a mesh depends on, hashed into the geometry cache keys
+static FString GetMeshCacheDescription(UStaticMesh* Mesh, TConstArrayView<UMaterialInterface*> Materials, const FMeshExportSettings& Settings)
+{
+    // Bump when the OBJ output changes so chunks from older versions are not reused
+    FString Description = TEXT("OBJChunk1|") + Mesh->GetPathName();
+
+#if WITH_EDITORONLY_DATA
+    // Changes whenever the mesh is rebuilt from changed source data or build settings
+    const FStaticMeshRenderData* RenderData = Mesh->GetRenderData();
+    Description += TEXT("|") + (RenderData ? RenderData->DerivedDataKey : FString());
+#endif
+
+    for (UMaterialInterface* Material : Materials)
+    {
+        Description += TEXT("|") + (Material ? Material->GetPathName() : FString());
+    }
+
+    Description += FString::Printf(TEXT("|%d|%d|%d|%d|%d|%d|"), Settings.FloatPrecision, Settings.bTrimTrailingZeros,
+        Settings.bDeduplicateAttributes, Settings.bExportFromRenderData, Settings.LODIndex, Settings.bOptimizeVertexOrder);
+    return Description;
+}
+
+bool AMeshMergerExporter::BuildExportScene(const TArray<AStaticMeshActor*>& Actors, const TArray<FMeshExportInstancedSelection>& InstancedSelections, FMeshExportScene& OutScene, TArray<UMaterialInterface*>& OutMaterials, const FMeshExportChunkCache* Cache)
+{
+    // Mesh and material combination used by the instances, only read once every instance is known
+    struct FSceneMesh
+    {
+        UStaticMesh* Mesh = nullptr;
+        TArray<UMaterialInterface*> Materials;
+        FString CacheDescription;
+        int64 NumTriangles = 0;
+        bool bNeedsData = false;
+    };
+    TArray<FSceneMesh> SceneMeshes;
+
+    // Components using the same mesh with the same materials share one copy of its geometry
+    TMap<UStaticMesh*, TArray<int32>> MeshVariants;
+
+    auto FindOrAddMesh = [this, &SceneMeshes, &MeshVariants, Cache](UStaticMeshComponent* SMC) -> int32
+    {
+        UStaticMesh* Mesh = SMC->GetStaticMesh();
+
+        // Component overrides replace the mesh materials, so they are part of what makes a mesh unique
+        TArray<UMaterialInterface*> Materials;
+        for (int32 MaterialIndex = 0; MaterialIndex < Mesh->GetStaticMaterials().Num(); MaterialIndex++)
+        {
+            Materials.Add(SMC->GetMaterial(MaterialIndex));
+        }
+
+        TArray<int32>& Variants = MeshVariants.FindOrAdd(Mesh);
+        for (int32 Variant : Variants)
+        {
+            if (SceneMeshes[Variant].Materials == Materials)
+            {
+                return Variant;
+            }
+        }
+
+        FSceneMesh& SceneMesh = SceneMeshes.AddDefaulted_GetRef();
+        SceneMesh.Mesh = Mesh;
+        SceneMesh.Materials = MoveTemp(Materials);
+        SceneMesh.bNeedsData = Cache == nullptr;
+        if (Cache)
+        {
+            SceneMesh.CacheDescription = GetMeshCacheDescription(Mesh, SceneMesh.Materials, ExportSettings);
+        }
+        return Variants.Add_GetRef(SceneMeshes.Num() - 1);
+    };
+
+    auto AddInstance = [&OutScene](const FString& Name, int32 MeshIndex, const FMatrix& Transform)
+    {
+        FMeshExportInstance& Instance = OutScene.Instances.AddDefaulted_GetRef();
+        Instance.Name = Name;
+        Instance.MeshIndex = MeshIndex;
+        Instance.SetTransform(Transform);
+    };
+
+    auto GetExportName = [this](AActor* Actor)
+    {
+#if WITH_EDITOR
+        return SanitizeFileName(Actor->GetActorLabel());
+#else
+        return SanitizeFileName(Actor->GetName());
+#endif
+    };
+
+    for (AStaticMeshActor* Actor : Actors)
+    {
+        UStaticMeshComponent* SMC = Actor ? Actor->GetStaticMeshComponent() : nullptr;
+        if (SMC && SMC->GetStaticMesh())
+        {
+            AddInstance(GetExportName(Actor), FindOrAddMesh(SMC), SMC->GetComponentTransform().ToMatrixWithScale());
+        }
+    }
+
+    for (const FMeshExportInstancedSelection& Selection : InstancedSelections)
+    {
+        UInstancedStaticMeshComponent* Component = Selection.Component;
+        if (!Component || !Component->GetStaticMesh())
+        {
+            continue;
+        }
+
+        const int32 MeshIndex = FindOrAddMesh(Component);
+        const FString BaseName = GetExportName(Component->GetOwner()) + TEXT("_") + SanitizeFileName(Component->GetName());
+        for (int32 InstanceIndex : Selection.InstanceIndices)
+        {
+            FTransform InstanceTransform;
+            if (Component->GetInstanceTransform(InstanceIndex, InstanceTransform, true))
+            {
+                AddInstance(FString::Printf(TEXT("%s_%d"), *BaseName, InstanceIndex), MeshIndex, InstanceTransform.ToMatrixWithScale());
+            }
+        }
+    }
+
+    // The triangle budget covers the whole scene, so every mesh keeps the same fraction of its triangles
+    float TriangleRatio = 1.0f;
+    if (ExportSettings.TargetTriangleCount > 0)
+    {
+        for (FSceneMesh& SceneMesh : SceneMeshes)
+        {
+            SceneMesh.NumTriangles = GetSourceTriangleCount(SceneMesh.Mesh, ExportSettings.LODIndex);
+        }
+
+        int64 TotalTriangles = 0;
+        for (const FMeshExportInstance& Instance : OutScene.Instances)
+        {
+            TotalTriangles += SceneMeshes[Instance.MeshIndex].NumTriangles;
+        }
+        TriangleRatio = GetTriangleRatio(TotalTriangles);
+    }
+
+    // A mesh only has to be read if one of its instances has no chunk that could be loaded, so a chunk that went
+    // missing or cannot be read since the cache was listed is written again instead of failing the export
+    if (Cache)
+    {
+        MESH_EXPORT_STAGE_SCOPE(ActiveReport, TEXT("Load cached objects"));
+        for (FMeshExportInstance& Instance : OutScene.Instances)
+        {
+            FSceneMesh& SceneMesh = SceneMeshes[Instance.MeshIndex];
+            FString Description = SceneMesh.CacheDescription + FString::Printf(TEXT("%.9g|"), TriangleRatio) + Instance.Name;
+            for (int32 Row = 0; Row < 4; Row++)
+            {
+                for (int32 Column = 0; Column < 4; Column++)
+                {
+                    Description += FString::Printf(TEXT("|%.17g"), Instance.Transform.M[Row][Column]);
+                }
+            }
+            Instance.CacheKey = FMeshExportChunkCache::MakeKey(Description);
+            if (!Cache->Load(Instance.CacheKey, Instance.CachedChunk))
+            {
+                Instance.CachedChunk.Empty();
+                SceneMesh.bNeedsData = true;
+            }
+        }
+    }
+
+    // Meshes that are fully cached are left empty; the ones that cannot be read are dropped along with their instances
+    TArray<int32> MeshRemap;
+    MeshRemap.Init(INDEX_NONE, SceneMeshes.Num());
+    int32 NumRead = 0;
+    for (int32 SceneMeshIndex = 0; SceneMeshIndex < SceneMeshes.Num(); SceneMeshIndex++)
+    {
+        const FSceneMesh& SceneMesh = SceneMeshes[SceneMeshIndex];
+        FMeshExportMeshData MeshData;
+        if (SceneMesh.bNeedsData)
+        {
+            if (!BuildExportData(SceneMesh.Mesh, SceneMesh.Materials, ExportSettings.LODIndex, TriangleRatio, MeshData))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("Skipping mesh %s, it could not be read"), *SceneMesh.Mesh->GetName());
+                continue;
+            }
+
+            if (ExportSettings.bOptimizeVertexOrder)
+            {
+                MESH_EXPORT_STAGE_SCOPE(ActiveReport, TEXT("Optimize vertex order"));
+                MeshData.OptimizeVertexOrder();
+            }
+            NumRead++;
+        }
+        MeshRemap[SceneMeshIndex] = OutScene.Meshes.Add(MoveTemp(MeshData));
+
+        for (UMaterialInterface* Material : SceneMesh.Materials)
+        {
+            if (Material)
+            {
+                OutMaterials.AddUnique(Material);
+            }
+        }
+    }
+
+    for (FMeshExportInstance& Instance : OutScene.Instances)
+    {
+        Instance.MeshIndex = MeshRemap[Instance.MeshIndex];
+    }
+    OutScene.Instances.RemoveAll([](const FMeshExportInstance& Instance) { return Instance.MeshIndex == INDEX_NONE; });
+
+    UE_LOG(LogTemp, Log, TEXT("Prepared %d instances using %d unique meshes, %d of them read"), OutScene.Instances.Num(), OutScene.Meshes.Num(), NumRead);
+    return OutScene.Instances.Num() > 0;
+}
+
+bool AMeshMergerExporter::ExportActors(const TArray<AStaticMeshActor*>& Actors, const TArray<FMeshExportInstancedSelection>& InstancedSelections, const FString& FilePath, bool bExportAsGLTF)
+{
+    const FString OutputPath = bExportAsGLTF ? FPaths::ChangeExtension(FilePath, TEXT("glb")) : FilePath;
+    const FString BasePath = FPaths::GetPath(OutputPath);
+
+    TUniquePtr<FMeshExportChunkCache> GeometryCache;
+    if (ExportSettings.bUseGeometryCache && !bExportAsGLTF)
+    {
+        GeometryCache = MakeUnique<FMeshExportChunkCache>(GetGeometryCacheDirectory(OutputPath));
+    }
+
+    FMeshExportScene Scene;
+    TArray<UMaterialInterface*> SceneMaterials;
+    if (!BuildExportScene(Actors, InstancedSelections, Scene, SceneMaterials, GeometryCache.Get()))
+    {
+        UE_LOG(LogTemp, Error, TEXT("No actor could be prepared for export"));
+        return false;
+    }
+
+    FMeshExportTextureExporter TextureExporter;
+    TextureExporter.Configure(ExportSettings, bExportAsGLTF);
+    TArray<FMeshExportMaterialEntry> Materials;
+    bool bSuccess = false;
+
+    if (bExportAsGLTF)
+    {
+        // Same order as ExportToGLTF: textures first so they can be embedded
+        CollectMaterialExports(SceneMaterials, BasePath, TextureExporter, Materials);
+        ProcessTextureJobs(TextureExporter, ExportSettings, ActiveReport);
+
+        TArray<FMeshExportGLBMaterial> GLBMaterials;
+        BuildGLBMaterials(Materials, TextureExporter, GLBMaterials);
+        bSuccess = FMeshExportGLBWriter::WriteScene(Scene, GLBMaterials, OutputPath, ExportSettings, nullptr, ActiveReport);
+        if (bSuccess)
+        {
+            DeleteEmbeddedImages(GLBMaterials, TextureExporter, ExportSettings);
+        }
+    }
+    else
+    {
+        const FString MTLFileName = FPaths::GetBaseFilename(OutputPath) + TEXT(".mtl");
+        bSuccess = FMeshExportOBJWriter::WriteScene(Scene, OutputPath, MTLFileName, ExportSettings, nullptr, GeometryCache.Get(), ActiveReport);
+        if (bSuccess)
+        {
+            if (GeometryCache)
+            {
+                GeometryCache->RemoveUnused();
+            }
+
+            CollectMaterialExports(SceneMaterials, BasePath, TextureExporter, Materials);
+            ProcessTextureJobs(TextureExporter, ExportSettings, ActiveReport);
+            WriteMTL(Materials, TextureExporter, BasePath, FPaths::GetCleanFilename(OutputPath), ActiveReport);
+        }
+    }
+
+    if (bSuccess)
+    {
+        UE_LOG(LogTemp, Log, TEXT("Successfully exported %d instances to: %s"), Scene.Instances.Num(), *OutputPath);
+    }
+    return bSuccess;
+}
+
+bool AMeshMergerExporter::ExportToOBJ(UStaticMesh* Mesh, const FString& FilePath)
+{
+    FMeshExportMeshData MeshData;
+    if (!BuildExportData(Mesh, MeshData))
+    {
+        return false;
+    }
+
+    FString MTLFileName = FPaths::GetBaseFilename(FilePath) + TEXT(".mtl");
+    bool bSuccess = FMeshExportOBJWriter::Write(MeshData, FilePath, MTLFileName, ExportSettings, nullptr, ActiveReport);
+
+    if (bSuccess)
+    {
+        UE_LOG(LogTemp, Log, TEXT("Successfully exported to OBJ: %s"), *FilePath);
+
+        // Export materials and textures
+        FString BasePath = FPaths::GetPath(FilePath);
+        FString OBJFileName = FPaths::GetCleanFilename(FilePath);
+        ExportMaterials(Mesh, BasePath, OBJFileName);
+    }
+
+    return bSuccess;
+}
+
+bool AMeshMergerExporter::ExportToGLTF(UStaticMesh* Mesh, const FString& FilePath)
+{
+    FMeshExportMeshData MeshData;
+    if (!BuildExportData(Mesh, MeshData))
+    {
+        return false;
+    }
+
+    // Always written as binary glTF, whatever extension was asked for
+    const FString GLBPath = FPaths::ChangeExtension(FilePath, TEXT("glb"));
+    const FString BasePath = FPaths::GetPath(GLBPath);
+
+    // Textures are written first so they can be embedded; glTF only allows PNG and JPEG images
+    FMeshExportTextureExporter TextureExporter;
+    TextureExporter.Configure(ExportSettings, true);
+    TArray<FMeshExportMaterialEntry> Materials;
+    CollectMaterialExports(Mesh, BasePath, TextureExporter, Materials);
+    ProcessTextureJobs(TextureExporter, ExportSettings, ActiveReport);
+
+    TArray<FMeshExportGLBMaterial> GLBMaterials;
+    BuildGLBMaterials(Materials, TextureExporter, GLBMaterials);
+
+    bool bSuccess = FMeshExportGLBWriter::Write(MeshData, GLBMaterials, GLBPath, ExportSettings, nullptr, ActiveReport);
+    if (bSuccess)
+    {
+        UE_LOG(LogTemp, Log, TEXT("Successfully exported to GLB: %s"), *GLBPath);
+        DeleteEmbeddedImages(GLBMaterials, TextureExporter, ExportSettings);
+    }
+
+    return bSuccess;
+}
+
+// Everything a merge created only exists for the export. The merge marks it standalone, which garbage collection
+// with the keep flags would never free, so that flag is cleared for the next collection to take it all.
+static void ReleaseMergedAssets(const TArray<UObject*>& Assets)
+{
+    for (UObject* Asset : Assets)
+    {
+        if (Asset)
+        {
+            Asset->ClearFlags(RF_Standalone);
+            Asset->MarkAsGarbage();
+        }
+    }
+}
+
+bool AMeshMergerExporter::ExportMerged(const TArray<AStaticMeshActor*>& Actors, const FString& FilePath, bool bExportAsGLTF, const FString& MeshName)
+{
+    UStaticMesh* MergedMesh = nullptr;
+    TArray<UObject*> CreatedAssets;
+    bool bSuccess = false;
+    if (!MergeMeshes(Actors, MergedMesh, MeshName, &CreatedAssets))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to merge meshes"));
+    }
+    else if (!MergedMesh)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Merged mesh is null"));
+    }
+    else
+    {
+        bSuccess = bExportAsGLTF ? ExportToGLTF(MergedMesh, FilePath) : ExportToOBJ(MergedMesh, FilePath);
+    }
+
+    ReleaseMergedAssets(CreatedAssets);
+    return bSuccess;
+}
+
+// Interleaves the low 10 bits of Value with two zero bits each, for a 3D Morton code
+static uint32 SpreadMortonBits(uint32 Value)
+{
+    Value &= 0x3FF;
+    Value = (Value | (Value << 16)) & 0x030000FF;
+    Value = (Value | (Value << 8)) & 0x0300F00F;
+    Value = (Value | (Value << 4)) & 0x030C30C3;
+    Value = (Value | (Value << 2)) & 0x09249249;
+    return Value;
+}
+
+void AMeshMergerExporter::SplitMergeBatches(const TArray<AStaticMeshActor*>& Actors, TArray<TArray<AStaticMeshActor*>>& OutBatches) const
+{
+    struct FBatchActor
+    {
+        AStaticMeshActor* Actor = nullptr;
+        uint32 MaterialSet = 0;
+        uint32 MortonCode = 0;
+        int64 NumTriangles = 0;
+    };
+
+    FBox WorldBounds(ForceInit);
+    for (AStaticMeshActor* Actor : Actors)
+    {
+        WorldBounds += Actor->GetStaticMeshComponent()->Bounds.GetBox();
+    }
+    const FVector CellSize = FVector::Max(WorldBounds.GetSize() / 1024.0, FVector(UE_KINDA_SMALL_NUMBER));
+
+    TArray<FBatchActor> BatchActors;
+    BatchActors.Reserve(Actors.Num());
+    for (AStaticMeshActor* Actor : Actors)
+    {
+        UStaticMeshComponent* Component = Actor->GetStaticMeshComponent();
+        FBatchActor& BatchActor = BatchActors.AddDefaulted_GetRef();
+        BatchActor.Actor = Actor;
+        BatchActor.NumTriangles = Component->GetStaticMesh() ? GetSourceTriangleCount(Component->GetStaticMesh(), ExportSettings.LODIndex) : 0;
+
+        // Hashed from the paths so the batches come out the same on every run
+        for (int32 MaterialIndex = 0; MaterialIndex < Component->GetNumMaterials(); MaterialIndex++)
+        {
+            const UMaterialInterface* Material = Component->GetMaterial(MaterialIndex);
+            BatchActor.MaterialSet = HashCombine(BatchActor.MaterialSet, Material ? GetTypeHash(Material->GetPathName()) : 0);
+        }
+
+        const FVector Cell = (Component->Bounds.Origin - WorldBounds.Min) / CellSize;
+        BatchActor.MortonCode = SpreadMortonBits(static_cast<uint32>(FMath::Clamp(Cell.X, 0.0, 1023.0)))
+            | (SpreadMortonBits(static_cast<uint32>(FMath::Clamp(Cell.Y, 0.0, 1023.0))) << 1)
+            | (SpreadMortonBits(static_cast<uint32>(FMath::Clamp(Cell.Z, 0.0, 1023.0))) << 2);
+    }
+
+    // Actors sharing materials end up next to each other, nearby ones first, and batches are cut from that order
+    BatchActors.Sort([](const FBatchActor& A, const FBatchActor& B)
+    {
+        return A.MaterialSet != B.MaterialSet ? A.MaterialSet < B.MaterialSet : A.MortonCode < B.MortonCode;
+    });
+
+    const int64 Budget = ExportSettings.MaxTrianglesPerMergeBatch;
+    int64 BatchTriangles = 0;
+    for (const FBatchActor& BatchActor : BatchActors)
+    {
+        if (OutBatches.Num() == 0 || (BatchTriangles > 0 && BatchTriangles + BatchActor.NumTriangles > Budget))
+        {
+            OutBatches.AddDefaulted();
+            BatchTriangles = 0;
+        }
+        OutBatches.Last().Add(BatchActor.Actor);
+        BatchTriangles += BatchActor.NumTriangles;
+    }
+}
+
+bool AMeshMergerExporter::ExportMergeBatches(const TArray<AStaticMeshActor*>& Actors, const FString& FilePath, bool bExportAsGLTF)
+{
+    TArray<TArray<AStaticMeshActor*>> Batches;
+    SplitMergeBatches(Actors, Batches);
+
+    const FString Directory = FPaths::GetPath(FilePath);
+    const FString BaseName = FPaths::GetBaseFilename(FilePath);
+    const FString Extension = bExportAsGLTF ? TEXT(".glb") : FPaths::GetExtension(FilePath, true);
+
+    UE_LOG(LogTemp, Log, TEXT("Merging %d actors in %d batches of up to %d triangles"), Actors.Num(), Batches.Num(), ExportSettings.MaxTrianglesPerMergeBatch);
+
+    // Each batch gets its own mesh name, so its material and atlas textures do not overwrite the previous batch's files
+    int32 NumExported = 0;
+    for (int32 BatchIndex = 0; BatchIndex < Batches.Num(); BatchIndex++)
+    {
+        const FString BatchPath = Directory / FString::Printf(TEXT("%s_batch%d%s"), *BaseName, BatchIndex, *Extension);
+        UE_LOG(LogTemp, Log, TEXT("Merging batch %d of %d (%d actors)"), BatchIndex + 1, Batches.Num(), Batches[BatchIndex].Num());
+
+        if (ExportMerged(Batches[BatchIndex], BatchPath, bExportAsGLTF, FString::Printf(TEXT("MergedMesh_Batch%d"), BatchIndex)))
+        {
+            NumExported++;
+        }
+        else
+        {
+            UE_LOG(LogTemp, Error, TEXT("Failed to export merge batch %d"), BatchIndex);
+        }
+
+        // Frees the merged mesh, its materials and the baked atlas before the next batch is merged
+        {
+            MESH_EXPORT_STAGE_SCOPE(ActiveReport, TEXT("Collect garbage"));
+            CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Exported %d of %d merge batches"), NumExported, Batches.Num());
+    return NumExported == Batches.Num();
+}
+
+bool AMeshMergerExporter::ExportTiles(const TArray<AStaticMeshActor*>& Actors, const TArray<FMeshExportInstancedSelection>& InstancedSelections, const FString& ExportPath, bool bExportAsGLTF)
+{
+    struct FExportTile
+    {
+        TArray<AStaticMeshActor*> Actors;
+        TArray<FMeshExportInstancedSelection> InstancedSelections;
+        int32 NumInstances = 0;
+        FBox Bounds = FBox(ForceInit);
+    };
+
+    // Actors and instances go to the cell holding the center of their bounds, so each one is exported exactly once
+    const double TileSize = ExportSettings.TileSize;
+    TMap<FIntPoint, FExportTile> Tiles;
+    auto GetTile = [&Tiles, TileSize](const FBoxSphereBounds& Bounds) -> FExportTile&
+    {
+        const FIntPoint Cell(FMath::FloorToInt32(Bounds.Origin.X / TileSize), FMath::FloorToInt32(Bounds.Origin.Y / TileSize));
+        FExportTile& Tile = Tiles.FindOrAdd(Cell);
+        Tile.Bounds += Bounds.GetBox();
+        return Tile;
+    };
+
+    for (AStaticMeshActor* Actor : Actors)
+    {
+        GetTile(Actor->GetStaticMeshComponent()->Bounds).Actors.Add(Actor);
+    }
+
+    // Instances of one component are placed one by one, so a level-wide foliage component is split over the tiles it covers
+    int32 NumInstances = 0;
+    for (const FMeshExportInstancedSelection& Selection : InstancedSelections)
+    {
+        const FBoxSphereBounds MeshBounds = Selection.Component->GetStaticMesh()->GetBounds();
+        for (int32 InstanceIndex : Selection.InstanceIndices)
+        {
+            FTransform InstanceTransform;
+            if (!Selection.Component->GetInstanceTransform(InstanceIndex, InstanceTransform, true))
+            {
+                continue;
+            }
+
+            FExportTile& Tile = GetTile(MeshBounds.TransformBy(InstanceTransform));
+            if (Tile.InstancedSelections.Num() == 0 || Tile.InstancedSelections.Last().Component != Selection.Component)
+            {
+                Tile.InstancedSelections.AddDefaulted_GetRef().Component = Selection.Component;
+            }
+            Tile.InstancedSelections.Last().InstanceIndices.Add(InstanceIndex);
+            Tile.NumInstances++;
+            NumInstances++;
+        }
+    }
+
+    // Row by row, so the file order does not depend on the order actors were found in
+    Tiles.KeySort([](const FIntPoint& A, const FIntPoint& B)
+    {
+        return A.Y != B.Y ? A.Y < B.Y : A.X < B.X;
+    });
+
+    const FString Directory = FPaths::GetPath(ExportPath);
+    const FString BaseName = FPaths::GetBaseFilename(ExportPath);
+    const FString Extension = bExportAsGLTF ? TEXT(".glb") : FPaths::GetExtension(ExportPath, true);
+
+    UE_LOG(LogTemp, Log, TEXT("Exporting %d actors and %d instances as %d tiles of %.0f units"),
+        Actors.Num(), NumInstances, Tiles.Num(), TileSize);
+
+    FString ManifestText;
+    TSharedRef<TJsonWriter<>> Manifest = TJsonWriterFactory<>::Create(&ManifestText);
+    Manifest->WriteObjectStart();
+    Manifest->WriteValue(TEXT("tileSize"), TileSize);
+    Manifest->WriteArrayStart(TEXT("tiles"));
+
+    // Tiles are exported one at a time and everything built for a tile is released before the next one,
+    // so memory use is set by the largest tile rather than the whole world
+    int32 NumExported = 0;
+    for (const TPair<FIntPoint, FExportTile>& Entry : Tiles)
+    {
+        const FExportTile& Tile = Entry.Value;
+        const FString TileFileName = FString::Printf(TEXT("%s_X%d_Y%d%s"), *BaseName, Entry.Key.X, Entry.Key.Y, *Extension);
+        const FString TilePath = Directory / TileFileName;
+
+        // Instanced components are only exported by the direct path, see MergeAndExportMeshes
+        bool bSuccess = false;
+        if (ExportSettings.bMergeMeshes)
+        {
+            bSuccess = ExportMerged(Tile.Actors, TilePath, bExportAsGLTF, FString::Printf(TEXT("MergedMesh_X%d_Y%d"), Entry.Key.X, Entry.Key.Y));
+            CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+        }
+        else
+        {
+            bSuccess = ExportActors(Tile.Actors, Tile.InstancedSelections, TilePath, bExportAsGLTF);
+        }
+
+        if (!bSuccess)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Failed to export tile %d, %d"), Entry.Key.X, Entry.Key.Y);
+            continue;
+        }
+        NumExported++;
+
+        Manifest->WriteObjectStart();
+        Manifest->WriteValue(TEXT("file"), TileFileName);
+        Manifest->WriteValue(TEXT("x"), Entry.Key.X);
+        Manifest->WriteValue(TEXT("y"), Entry.Key.Y);
+        Manifest->WriteValue(TEXT("actors"), Tile.Actors.Num());
+        Manifest->WriteValue(TEXT("instancedComponents"), Tile.InstancedSelections.Num());
+        Manifest->WriteValue(TEXT("instances"), Tile.NumInstances);
+        Manifest->WriteArrayStart(TEXT("min"));
+        Manifest->WriteValue(Tile.Bounds.Min.X);
+        Manifest->WriteValue(Tile.Bounds.Min.Y);
+        Manifest->WriteValue(Tile.Bounds.Min.Z);
+        Manifest->WriteArrayEnd();
+        Manifest->WriteArrayStart(TEXT("max"));
+        Manifest->WriteValue(Tile.Bounds.Max.X);
+        Manifest->WriteValue(Tile.Bounds.Max.Y);
+        Manifest->WriteValue(Tile.Bounds.Max.Z);
+        Manifest->WriteArrayEnd();
+        Manifest->WriteObjectEnd();
+    }
+
+    Manifest->WriteArrayEnd();
+    Manifest->WriteObjectEnd();
+    Manifest->Close();
+
+    const FString ManifestPath = Directory / (BaseName + TEXT("_tiles.json"));
+    if (!FFileHelper::SaveStringToFile(ManifestText, *ManifestPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to save tile manifest: %s"), *ManifestPath);
+        return false;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Exported %d of %d tiles, manifest: %s"), NumExported, Tiles.Num(), *ManifestPath);
+    return NumExported == Tiles.Num();
+}
+
+void AMeshMergerExporter::MergeAndExportMeshes(const FString& ExportPath, bool bExportAsGLTF)
+{
+    UE_LOG(LogTemp, Log, TEXT("Starting mesh merge and export process..."));
+
+    // Every stage below adds itself to the report, which is logged and optionally saved however the export ends
+    const double StartTime = FPlatformTime::Seconds();
+    LastExportReport.Reset();
+    LastExportReport.FilePath = bExportAsGLTF ? FPaths::ChangeExtension(ExportPath, TEXT("glb")) : ExportPath;
+    TGuardValue<FMeshExportReport*> ReportScope(ActiveReport, &LastExportReport);
+    MaterialResolver.Reset();
+    bool bSuccess = false;
+    ON_SCOPE_EXIT
+    {
+        FinishReport(LastExportReport, ExportSettings, StartTime, bSuccess);
+    };
+
+    // Collect all static mesh actors
+    TArray<AStaticMeshActor*> StaticMeshActors;
+    TArray<FMeshExportInstancedSelection> InstancedSelections;
+    {
+        MESH_EXPORT_STAGE_SCOPE(ActiveReport, TEXT("Collect actors"), nullptr, true);
+        CollectStaticMeshActors(StaticMeshActors);
+
+        // Instanced meshes are only exported by the direct path, the merge works on whole components
+        if (!ExportSettings.bMergeMeshes && ExportSettings.bIncludeInstancedMeshes)
+        {
+            CollectInstancedMeshComponents(InstancedSelections);
+        }
+    }
+
+    if (StaticMeshActors.Num() == 0 && InstancedSelections.Num() == 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("No static mesh actors found in level"));
+        return;
+    }
+
+    // Ensure export directory exists
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    FString ExportDir = FPaths::GetPath(ExportPath);
+    PlatformFile.CreateDirectoryTree(*ExportDir);
+
+    if (ExportSettings.TileSize > 0.0f)
+    {
+        bSuccess = ExportTiles(StaticMeshActors, InstancedSelections, ExportPath, bExportAsGLTF);
+        if (!bSuccess)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Failed to export some tiles"));
+        }
+        return;
+    }
+
+    // Without merging, actors are written straight from their own meshes
+    if (!ExportSettings.bMergeMeshes)
+    {
+        bSuccess = ExportActors(StaticMeshActors, InstancedSelections, ExportPath, bExportAsGLTF);
+        if (!bSuccess)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Failed to export actors"));
+        }
+        return;
+    }
+
+    if (ExportSettings.MaxTrianglesPerMergeBatch > 0)
+    {
+        bSuccess = ExportMergeBatches(StaticMeshActors, ExportPath, bExportAsGLTF);
+        if (!bSuccess)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Failed to export some merge batches"));
+        }
+        return;
+    }
+
+    bSuccess = ExportMerged(StaticMeshActors, ExportPath, bExportAsGLTF);
+    if (bSuccess)
+    {
+        UE_LOG(LogTemp, Log, TEXT("Successfully exported merged mesh to: %s"), *LastExportReport.FilePath);
+    }
+    else
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to export merged mesh"));
+    }
+}
+
+// State carried between the stages of MergeAndExportMeshesAsync
+struct FMeshMergeExportAsyncState
+{
+    FMeshMergeExportAsyncState(AMeshMergerExporter* InExporter, const TSharedRef<FMeshExportProgress>& InProgress)
+        : Exporter(InExporter)
+        , Settings(InExporter->ExportSettings)
+        , Progress(InProgress)
+    {
+    }
+
+    TWeakObjectPtr<AMeshMergerExporter> Exporter;
+    FMeshExportSettings Settings;
+    TSharedRef<FMeshExportProgress> Progress;
+    TPromise<bool> Promise;
+
+    FString FilePath;
+    bool bExportAsGLTF = false;
+    TArray<TWeakObjectPtr<AStaticMeshActor>> Actors;
+    TArray<TWeakObjectPtr<UInstancedStaticMeshComponent>> InstancedComponents;
+    TArray<TArray<int32>> InstanceIndices;
+    TStrongObjectPtr<UStaticMesh> MergedMesh;
+    // Kept alive by their standalone flag until AsyncFinish releases them
+    TArray<TWeakObjectPtr<UObject>> CreatedAssets;
+    FMeshExportMeshData MeshData;
+    FMeshExportScene Scene;
+    TUniquePtr<FMeshExportChunkCache> GeometryCache;
+    TUniquePtr<FMeshExportTextureExporter> TextureExporter;
+    TArray<FMeshExportMaterialEntry> Materials;
+
+    // Only one stage runs at a time, so the report is never touched by two threads at once
+    FMeshExportReport Report;
+    double StartTime = 0.0;
+};
+
+TFuture<bool> AMeshMergerExporter::MergeAndExportMeshesAsync(const FString& ExportPath, bool bExportAsGLTF, TSharedRef<FMeshExportProgress> Progress)
+{
+    check(IsInGameThread());
+
+    TSharedRef<FMeshMergeExportAsyncState> State = MakeShared<FMeshMergeExportAsyncState>(this, Progress);
+
+    // glTF is always written as GLB, see ExportToGLTF
+    State->bExportAsGLTF = bExportAsGLTF;
+    State->FilePath = bExportAsGLTF ? FPaths::ChangeExtension(ExportPath, TEXT("glb")) : ExportPath;
+    State->Report.FilePath = State->FilePath;
+    State->StartTime = FPlatformTime::Seconds();
+
+    TFuture<bool> Future = State->Promise.GetFuture();
+
+    UE_LOG(LogTemp, Log, TEXT("Starting asynchronous mesh merge and export process..."));
+
+    // Every game thread stage is queued as its own task so the frame keeps ticking between them
+    AsyncTask(ENamedThreads::GameThread, [State]() { AsyncCollectStage(State); });
+    return Future;
+}
+
+void AMeshMergerExporter::AsyncCollectStage(TSharedRef<FMeshMergeExportAsyncState> State)
+{
+    AMeshMergerExporter* Exporter = State->Exporter.Get();
+    if (!Exporter || State->Progress->IsCancelled())
+    {
+        AsyncFinish(State, false);
+        return;
+    }
+
+    State->Progress->BeginStage(TEXT("Collecting actors"), 0.0f, 0.05f);
+    if (State->Settings.TileSize > 0.0f)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Tiled export is only done by MergeAndExportMeshes, writing a single file"));
+    }
+    else if (State->Settings.bMergeMeshes && State->Settings.MaxTrianglesPerMergeBatch > 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Merge batches are only done by MergeAndExportMeshes, merging everything at once"));
+    }
+
+    // The filter reads the exporter's settings, which may have been edited since the export started
+    TGuardValue<FMeshExportSettings> SettingsScope(Exporter->ExportSettings, State->Settings);
+
+    TArray<AStaticMeshActor*> StaticMeshActors;
+    TArray<FMeshExportInstancedSelection> InstancedSelections;
+    {
+        MESH_EXPORT_STAGE_SCOPE(&State->Report, TEXT("Collect actors"), nullptr, true);
+        Exporter->CollectStaticMeshActors(StaticMeshActors);
+
+        if (!State->Settings.bMergeMeshes && State->Settings.bIncludeInstancedMeshes)
+        {
+            Exporter->CollectInstancedMeshComponents(InstancedSelections);
+        }
+    }
+
+    if (StaticMeshActors.Num() == 0 && InstancedSelections.Num() == 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("No static mesh actors found in level"));
+        AsyncFinish(State, false);
+        return;
+    }
+
+    // Actors can be destroyed before the next stage runs, so only weak references are kept
+    State->Actors.Append(StaticMeshActors);
+    for (FMeshExportInstancedSelection& Selection : InstancedSelections)
+    {
+        State->InstancedComponents.Add(Selection.Component);
+        State->InstanceIndices.Add(MoveTemp(Selection.InstanceIndices));
+    }
+
+    State->Progress->BeginStage(TEXT("Merging meshes"), 0.05f, 0.35f);
+    AsyncTask(ENamedThreads::GameThread, [State]() { AsyncMergeStage(State); });
+}
+
+void AMeshMergerExporter::AsyncMergeStage(TSharedRef<FMeshMergeExportAsyncState> State)
+{
+    AMeshMergerExporter* Exporter = State->Exporter.Get();
+    if (!Exporter || State->Progress->IsCancelled())
+    {
+        AsyncFinish(State, false);
+        return;
+    }
+
+    TArray<AStaticMeshActor*> StaticMeshActors;
+    for (const TWeakObjectPtr<AStaticMeshActor>& Actor : State->Actors)
+    {
+        if (Actor.IsValid())
+        {
+            StaticMeshActors.Add(Actor.Get());
+        }
+    }
+    State->Actors.Empty();
+
+    TArray<FMeshExportInstancedSelection> InstancedSelections;
+    for (int32 SelectionIndex = 0; SelectionIndex < State->InstancedComponents.Num(); SelectionIndex++)
+    {
+        if (UInstancedStaticMeshComponent* Component = State->InstancedComponents[SelectionIndex].Get())
+        {
+            FMeshExportInstancedSelection& Selection = InstancedSelections.AddDefaulted_GetRef();
+            Selection.Component = Component;
+            Selection.InstanceIndices = MoveTemp(State->InstanceIndices[SelectionIndex]);
+        }
+    }
+    State->InstancedComponents.Empty();
+    State->InstanceIndices.Empty();
+
+    // The exporter's own stages are added to this export's report while it runs them, and use the settings the export
+    // started with rather than the ones edited since
+    TGuardValue<FMeshExportReport*> ReportScope(Exporter->ActiveReport, &State->Report);
+    TGuardValue<FMeshExportSettings> SettingsScope(Exporter->ExportSettings, State->Settings);
+    Exporter->MaterialResolver.Reset();
+
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    PlatformFile.CreateDirectoryTree(*FPaths::GetPath(State->FilePath));
+
+    State->TextureExporter = MakeUnique<FMeshExportTextureExporter>();
+    State->TextureExporter->Configure(State->Settings, State->bExportAsGLTF);
+
+    // Without merging, the actors' own meshes are copied out directly
+    if (!State->Settings.bMergeMeshes)
+    {
+        State->Progress->BeginStage(TEXT("Preparing mesh data"), 0.05f, 0.4f);
+        if (State->Settings.bUseGeometryCache && !State->bExportAsGLTF)
+        {
+            State->GeometryCache = MakeUnique<FMeshExportChunkCache>(GetGeometryCacheDirectory(State->FilePath));
+        }
+
+        TArray<UMaterialInterface*> SceneMaterials;
+        if (!Exporter->BuildExportScene(StaticMeshActors, InstancedSelections, State->Scene, SceneMaterials, State->GeometryCache.Get()))
+        {
+            UE_LOG(LogTemp, Error, TEXT("No actor could be prepared for export"));
+            AsyncFinish(State, false);
+            return;
+        }
+        Exporter->CollectMaterialExports(SceneMaterials, FPaths::GetPath(State->FilePath), *State->TextureExporter, State->Materials);
+
+        State->Progress->BeginStage(TEXT("Exporting textures"), 0.4f, 0.6f);
+        AsyncTexturesStage(State);
+        return;
+    }
+
+    // Merging creates UObjects and has to stay on the game thread. The name is unique so a synchronous export running
+    // meanwhile never finds these assets in the transient package.
+    UStaticMesh* MergedMesh = nullptr;
+    TArray<UObject*> CreatedAssets;
+    const bool bMerged = Exporter->MergeMeshes(StaticMeshActors, MergedMesh, FString::Printf(TEXT("MergedMesh_%s"), *FGuid::NewGuid().ToString()), &CreatedAssets);
+    for (UObject* Asset : CreatedAssets)
+    {
+        State->CreatedAssets.Add(Asset);
+    }
+    if (!bMerged || !MergedMesh)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to merge meshes"));
+        AsyncFinish(State, false);
+        return;
+    }
+    State->MergedMesh.Reset(MergedMesh);
+
+    // Copy the geometry out of the mesh so the writers do not touch UObjects
+    State->Progress->BeginStage(TEXT("Preparing mesh data"), 0.35f, 0.4f);
+    if (State->Progress->IsCancelled() || !Exporter->BuildExportData(MergedMesh, State->MeshData))
+    {
+        AsyncFinish(State, false);
+        return;
+    }
+
+    // Materials and textures are looked up here as well, the textures are then exported on workers
+    Exporter->CollectMaterialExports(MergedMesh, FPaths::GetPath(State->FilePath), *State->TextureExporter, State->Materials);
+
+    State->Progress->BeginStage(TEXT("Exporting textures"), 0.4f, 0.6f);
+    AsyncTexturesStage(State);
+}
+
+void AMeshMergerExporter::AsyncTexturesStage(TSharedRef<FMeshMergeExportAsyncState> State)
+{
+    const double StartTime = FPlatformTime::Seconds();
+    const int64 StartUsedPhysical = FMeshExportReport::GetUsedPhysical();
+    Async(EAsyncExecution::ThreadPool, [State, StartTime, StartUsedPhysical]()
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE_STR(TEXT("Textures"));
+        State->TextureExporter->ProcessJobs(State->Settings.MaxConcurrentTextureJobs, &State->Progress.Get());
+
+        AsyncTask(ENamedThreads::GameThread, [State, StartTime, StartUsedPhysical]()
+        {
+            if (State->Progress->IsCancelled())
+            {
+                AsyncFinish(State, false);
+                return;
+            }
+
+            // Reading platform data needs the game thread; it is only used for textures without source data
+            if (State->TextureExporter->PreparePlatformDataFallbacks())
+            {
+                State->TextureExporter->ProcessJobs(State->Settings.MaxConcurrentTextureJobs, &State->Progress.Get());
+                if (State->Progress->IsCancelled())
+                {
+                    AsyncFinish(State, false);
+                    return;
+                }
+            }
+            State->TextureExporter->SaveDiskCache();
+
+            // Includes the wait for the game thread, like the textures stage of MergeAndExportMeshes
+            State->Report.AddStage(TEXT("Textures"), FPlatformTime::Seconds() - StartTime);
+            State->Report.AddStageMemory(TEXT("Textures"), StartUsedPhysical, FMeshExportReport::GetUsedPhysical());
+            State->TextureExporter->AddToReport(State->Report);
+
+            // Nothing past this point needs the merged mesh
+            State->MergedMesh.Reset();
+
+            State->Progress->BeginStage(TEXT("Writing geometry"), 0.6f, 1.0f);
+            AsyncWriteStage(State);
+        });
+    });
+}
+
+void AMeshMergerExporter::AsyncWriteStage(TSharedRef<FMeshMergeExportAsyncState> State)
+{
+    Async(EAsyncExecution::ThreadPool, [State]()
+    {
+        // A scene is only built when the actors are not merged
+        const bool bWriteScene = State->Scene.Instances.Num() > 0;
+        FMeshExportProgress* Progress = &State->Progress.Get();
+        FMeshExportReport* Report = &State->Report;
+
+        bool bWritten = false;
+        if (State->bExportAsGLTF)
+        {
+            TArray<FMeshExportGLBMaterial> GLBMaterials;
+            BuildGLBMaterials(State->Materials, *State->TextureExporter, GLBMaterials);
+            bWritten = bWriteScene
+                ? FMeshExportGLBWriter::WriteScene(State->Scene, GLBMaterials, State->FilePath, State->Settings, Progress, Report)
+                : FMeshExportGLBWriter::Write(State->MeshData, GLBMaterials, State->FilePath, State->Settings, Progress, Report);
+            if (bWritten)
+            {
+                DeleteEmbeddedImages(GLBMaterials, *State->TextureExporter, State->Settings);
+            }
+        }
+        else
+        {
+            const FString MTLFileName = FPaths::GetBaseFilename(State->FilePath) + TEXT(".mtl");
+            bWritten = bWriteScene
+                ? FMeshExportOBJWriter::WriteScene(State->Scene, State->FilePath, MTLFileName, State->Settings, Progress, State->GeometryCache.Get(), Report)
+                : FMeshExportOBJWriter::Write(State->MeshData, State->FilePath, MTLFileName, State->Settings, Progress, Report);
+            if (bWritten)
+            {
+                if (State->GeometryCache)
+                {
+                    State->GeometryCache->RemoveUnused();
+                }
+
+                UE_LOG(LogTemp, Log, TEXT("Successfully exported to OBJ: %s"), *State->FilePath);
+                WriteMTL(State->Materials, *State->TextureExporter, FPaths::GetPath(State->FilePath), FPaths::GetCleanFilename(State->FilePath), Report);
+            }
+        }
+
+        AsyncTask(ENamedThreads::GameThread, [State, bWritten]()
+        {
+            State->MeshData.Reset();
+            State->Scene.Reset();
+            State->GeometryCache.Reset();
+            State->TextureExporter.Reset();
+
+            if (bWritten)
+            {
+                UE_LOG(LogTemp, Log, TEXT("Successfully exported merged mesh to: %s"), *State->FilePath);
+            }
+            AsyncFinish(State, bWritten);
+        });
+    });
+}
+
+void AMeshMergerExporter::AsyncFinish(TSharedRef<FMeshMergeExportAsyncState> State, bool bSuccess)
+{
+    if (!bSuccess && State->Progress->IsCancelled())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Mesh merge and export cancelled"));
+    }
+    else if (!bSuccess)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to export merged mesh"));
+    }
+    else
+    {
+        State->Progress->SetStageProgress(1.0f);
+    }
+
+    FinishReport(State->Report, State->Settings, State->StartTime, bSuccess);
+    if (AMeshMergerExporter* Exporter = State->Exporter.Get())
+    {
+        Exporter->LastExportReport = State->Report;
+    }
+
+    // Strong object pointers have to be released on the game thread, as do the merged assets
+    State->MergedMesh.Reset();
+    TArray<UObject*> CreatedAssets;
+    for (const TWeakObjectPtr<UObject>& Asset : State->CreatedAssets)
+    {
+        CreatedAssets.Add(Asset.Get());
+    }
+    State->CreatedAssets.Reset();
+    ReleaseMergedAssets(CreatedAssets);
+
+    State->Promise.SetValue(bSuccess);
+}
@@ -1,29 +1,101 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "GameFramework/Actor.h"
-#include "Engine/StaticMeshActor.h"
-#include "MeshMergerExporter.generated.h"
-
-UCLASS()
-class SAFRAN_APP_API AMeshMergerExporter : public AActor
-{
-	GENERATED_BODY()
-
-public:
-	// Sets default values for this actor's properties
-	AMeshMergerExporter();
-
-	UFUNCTION(BlueprintCallable, Category = "Mesh Merger")
-	void MergeAndExportMeshes(const FString& ExportPath, bool bExportAsGLTF = true);
-
-private:
-	void CollectStaticMeshActors(TArray<AStaticMeshActor*>& OutActors);
-	bool MergeMeshes(const TArray<AStaticMeshActor*>& Actors, UStaticMesh*& OutMergedMesh);
-	bool ExportToOBJ(UStaticMesh* Mesh, const FString& FilePath);
-	bool ExportToGLTF(UStaticMesh* Mesh, const FString& FilePath);
-	void ExportMaterials(UStaticMesh* Mesh, const FString& BasePath, const FString& OBJFileName);
-	FString SanitizeFileName(const FString& FileName);
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Engine/StaticMeshActor.h"
+#include "MeshExportTypes.h"
+#include "MeshExportReport.h"
+#include "MeshExportMaterials.h"
+#include "Async/Future.h"
+#include "MeshMergerExporter.generated.h"
+
+struct FMeshExportMeshData;
+struct FMeshExportMaterialEntry;
+struct FMeshExportGLBMaterial;
+struct FMeshExportScene;
+class FMeshExportChunkCache;
+class FMeshExportTextureExporter;
+class UInstancedStaticMeshComponent;
+struct FMeshMergeExportAsyncState;
+
+/** Instances of one instanced static mesh component picked for export, each tested and placed on its own. */
+struct FMeshExportInstancedSelection
+{
+	UInstancedStaticMeshComponent* Component = nullptr;
+	TArray<int32> InstanceIndices;
+};
+
+UCLASS()
+class SAFRAN_APP_API AMeshMergerExporter : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this actor's properties
+	AMeshMergerExporter();
+
+	UFUNCTION(BlueprintCallable, Category = "Mesh Merger")
+	void MergeAndExportMeshes(const FString& ExportPath, bool bExportAsGLTF = true);
+
+	/**
+	 * Non-blocking version of MergeAndExportMeshes. Collecting and merging actors, copying the merged geometry and
+	 * looking up materials run on the game thread spread over several frames; textures and the file are written on workers.
+	 * The future resolves on the game thread with the overall result. Progress reports the current stage and can cancel the export.
+	 * ExportSettings is copied when the export starts, so editing it meanwhile only affects the next export.
+	 */
+	TFuture<bool> MergeAndExportMeshesAsync(const FString& ExportPath, bool bExportAsGLTF, TSharedRef<FMeshExportProgress> Progress);
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh Merger")
+	FMeshExportSettings ExportSettings;
+
+	/** Stage timings of the last export that finished, synchronous or not. */
+	UPROPERTY(BlueprintReadOnly, Category = "Mesh Merger")
+	FMeshExportReport LastExportReport;
+
+private:
+	bool PassesFilter(const UStaticMeshComponent* Component) const;
+	/** The tests of PassesFilter that do not depend on where the geometry is. */
+	bool PassesComponentFilter(const UStaticMeshComponent* Component) const;
+	bool PassesBoundsFilter(const FBoxSphereBounds& Bounds) const;
+	void CollectStaticMeshActors(TArray<AStaticMeshActor*>& OutActors);
+	void CollectInstancedMeshComponents(TArray<FMeshExportInstancedSelection>& OutSelections);
+	bool MergeMeshes(const TArray<AStaticMeshActor*>& Actors, UStaticMesh*& OutMergedMesh, const FString& MeshName = TEXT("MergedMesh"), TArray<UObject*>* OutCreatedAssets = nullptr);
+	bool BuildExportData(UStaticMesh* Mesh, FMeshExportMeshData& OutData);
+	bool BuildExportData(UStaticMesh* Mesh, TConstArrayView<UMaterialInterface*> Materials, int32 LODIndex, float TriangleRatio, FMeshExportMeshData& OutData);
+	int64 GetSourceTriangleCount(UStaticMesh* Mesh, int32 LODIndex) const;
+	float GetTriangleRatio(int64 NumTriangles) const;
+	bool BuildExportScene(const TArray<AStaticMeshActor*>& Actors, const TArray<FMeshExportInstancedSelection>& InstancedSelections, FMeshExportScene& OutScene, TArray<UMaterialInterface*>& OutMaterials, const FMeshExportChunkCache* Cache = nullptr);
+	bool ExportActors(const TArray<AStaticMeshActor*>& Actors, const TArray<FMeshExportInstancedSelection>& InstancedSelections, const FString& FilePath, bool bExportAsGLTF);
+	bool ExportMerged(const TArray<AStaticMeshActor*>& Actors, const FString& FilePath, bool bExportAsGLTF, const FString& MeshName = TEXT("MergedMesh"));
+	void SplitMergeBatches(const TArray<AStaticMeshActor*>& Actors, TArray<TArray<AStaticMeshActor*>>& OutBatches) const;
+	bool ExportMergeBatches(const TArray<AStaticMeshActor*>& Actors, const FString& FilePath, bool bExportAsGLTF);
+	bool ExportTiles(const TArray<AStaticMeshActor*>& Actors, const TArray<FMeshExportInstancedSelection>& InstancedSelections, const FString& ExportPath, bool bExportAsGLTF);
+	bool ExportToOBJ(UStaticMesh* Mesh, const FString& FilePath);
+	bool ExportToGLTF(UStaticMesh* Mesh, const FString& FilePath);
+	void ExportMaterials(UStaticMesh* Mesh, const FString& BasePath, const FString& OBJFileName);
+	void CollectMaterialExports(UStaticMesh* Mesh, const FString& BasePath, FMeshExportTextureExporter& TextureExporter, TArray<FMeshExportMaterialEntry>& OutMaterials);
+	void CollectMaterialExports(TConstArrayView<UMaterialInterface*> Materials, const FString& BasePath, FMeshExportTextureExporter& TextureExporter, TArray<FMeshExportMaterialEntry>& OutMaterials);
+	static bool WriteMTL(const TArray<FMeshExportMaterialEntry>& Materials, const FMeshExportTextureExporter& TextureExporter, const FString& BasePath, const FString& OBJFileName, FMeshExportReport* Report = nullptr);
+	static void ProcessTextureJobs(FMeshExportTextureExporter& TextureExporter, const FMeshExportSettings& Settings, FMeshExportReport* Report = nullptr);
+	static void FinishReport(FMeshExportReport& Report, const FMeshExportSettings& Settings, double StartTime, bool bSuccess);
+	static void BuildGLBMaterials(const TArray<FMeshExportMaterialEntry>& Materials, const FMeshExportTextureExporter& TextureExporter, TArray<FMeshExportGLBMaterial>& OutMaterials);
+	/** Deletes the image files a GLB was written with once they are embedded in it, unless they are kept as the texture cache. */
+	static void DeleteEmbeddedImages(const TArray<FMeshExportGLBMaterial>& Materials, const FMeshExportTextureExporter& TextureExporter, const FMeshExportSettings& Settings);
+	FString SanitizeFileName(const FString& FileName);
+	static FString GetGeometryCacheDirectory(const FString& FilePath);
+
+	// Stages of MergeAndExportMeshesAsync, each one schedules the next
+	static void AsyncCollectStage(TSharedRef<FMeshMergeExportAsyncState> State);
+	static void AsyncMergeStage(TSharedRef<FMeshMergeExportAsyncState> State);
+	static void AsyncTexturesStage(TSharedRef<FMeshMergeExportAsyncState> State);
+	static void AsyncWriteStage(TSharedRef<FMeshMergeExportAsyncState> State);
+	static void AsyncFinish(TSharedRef<FMeshMergeExportAsyncState> State, bool bSuccess);
+
+	/** Report the stages of the running export are added to, null when nothing is being timed. */
+	FMeshExportReport* ActiveReport = nullptr;
+
+	/** Material textures looked up so far by the running export; reset when an export starts. */
+	FMeshExportMaterialResolver MaterialResolver;
+};